@@ -3,6 +3,20 @@
 // File:      TMC-24-IO.ino
 // Author:    Aiko Pras
 // History:   2024/02/29 AP Version 1.0
+//            2026/10/17 agent Version 1.1: inputs are sampled by the TCA0 interrupt (sampler.h)
+//            2026/10/17 agent Version 1.2: portClass::check() handles all 8 pins of a port at once
+//            2026/10/17 agent Version 1.3: event mode: sampling stops while all inputs are stable (Input_Mode)
+//            2026/10/17 agent Version 1.4: optional profiling of the steps of loop() (profiler.h)
+//            2026/10/17 agent Version 1.5: the log is printed from loop() (logger.h)
+//            2026/10/17 agent Version 1.6: the POORTs are described by constexpr descriptors (hardware.h)
+//            2026/10/17 agent Version 1.7: inputs and outputs on one POORT (Dir_Override, Dir_Mask)
+//            2026/10/17 agent Version 1.8: local links from an input pin to an output pin (links.h)
+//            2026/10/17 agent Version 1.9: the input state is restored from EEPROM at power-up (persist.h)
+//            2026/10/17 agent Version 1.10: adaptive sampling rate: busy() while debouncing
+//            2026/10/17 agent Version 1.11: port[].init() gets the POORT number, for the debounce profiles
+//            2026/10/17 agent Version 1.12: LOG_LEVEL 3 traces the samples of the POORTs (logger.h)
+//            2026/10/17 agent Version 1.13: feedback: new input changes are sent before resyncs (rsBus.h)
+//            2026/10/17 agent Version 1.14: the task number is the index in tasks[], for the profiler and the scheduler
 //
 // Purpose:   24 Channel (3 x 8) IO-decoder for the TMC (Twentse Modelspoorwegclub).
 //            Interfaces between the 25 pin SUB-D connectors that are used in the current layout,
@@ -30,9 +44,13 @@
 #include "dccIn.h"                    // To handle all DCC input signals
 #include "input.h"                    // To handle all IO input pins
 #include "rsBus.h"                    // To sen RS-Bus feedback messages
-
-DccTimer inputIntervalTimer;          // To avoid overload, we check input pins only when timer expires
-uint8_t startUpPhase;                 // To assure we have sufficient samples for a stable input value   
+#include "sampler.h"                  // Timer interrupt that samples the IO input pins
+#include "links.h"                    // Input pins that directly drive output pins
+#include "persist.h"                  // Input state that is kept in EEPROM during power off
+#include "scheduler.h"                // Executes the tasks of loop() when they are due
+#include "virtualCVs.h"               // Read-only CVs that reflect the decoder state
+#include "profiler.h"                 // To measure the duration of the steps in loop()
+#include "logger.h"                   // Non-blocking logging
 
 
 //******************************************************************************************************
@@ -48,7 +66,7 @@ void print_CVs_and_Other_Info() {
   Serial.print("First Decoder Address: "); 
   Serial.println(cvValues.storedAddress()); 
   Serial.print("First RS-Bus Address: "); 
-  Serial.println(feedback[1].rsbus.address - 1); 
+  Serial.println(feedback0.rsbus.address); 
 }                  
 
 
@@ -69,64 +87,135 @@ void setup() {
   //
   leds.init();
   //
+  // Initialise the DCC input. This also initialises the CVs, thus should be done first
+  dcc_in.init();
+  //
   // Initialise the 3 DIP switch input pins, as well as the (DIR register of the) 3 ports as IN or OUT 
   dipSwitches.init();
+  links.init();
   //
-  // Initialise the DCC input
-  dcc_in.init();
+  // To reduce load, we do not sample input pins continously, but only at a certain interval (in ms)
+  // Sampling is done by a timer interrupt, to be independent of the time loop() needs
+  sampler.init();
   //
-  // initialse each of the three I/O ports
-  for (uint8_t i = 0; i < 3; i++) {port[i].init();}
+  // initialse each of the three I/O ports. The sampler determines the number of samples to debounce
+  for (uint8_t i = 0; i < 3; i++) {port[i].init(i);}
+  //
+  // Restore the input state from before the power off, thus feedback can be given immediately
+  persist.init();
+  //
+  // Set the outputs of all links according to the (restored) inputs
+  links.start();
   //
   // Assign addresses to each of the three RS-Bus connections
   RSCommon.init();
   //
-  // To reduce load, we do not sample input pins continously, but only at a certain interval (in ms)
-  inputIntervalTimer.setTime(cvValues.read(Int_Samples));
-  inputIntervalTimer.start();
-  //
-  // To prevent us from sending feedback data before the value of the input pins are stable,
-  // we introduce an artificial delay to ensure we have collected a sufficient number of samples
-  // to expect the input value is stable. We take an "arbitraty value as starting point.
-  startUpPhase = cvValues.read(Start_Delay);
+  // PoM reads of the read-only CVs are answered from RAM, via our own RS-Bus connection
+  virtualCVs.init();
   //
   print_CVs_and_Other_Info();
+  //
+  // The tasks of loop() start now
+  scheduler.init();
 }
 
 
 //******************************************************************************************************
-void loop() { 
-  // Step 1: Read the DIP switch settings, and (re)configure DIR of the AVR output ports if needed
-  dipSwitches.check();
-  // Step2: Check if we received a DCC message for this decoder
+// The tasks of loop(). They are executed by the scheduler, see tasks[] below
+void taskDcc() {
+  // Check if we received a DCC message for this decoder
   // If yes, write to the associataed output port, if the DIP switches allow that
   dcc_in.check();
-  // Step3: Check for each port that is configured as input if one or more input pins changed.
-  // To reduce load, we sample only at certain intervals (default: 10 ms)
-  if (inputIntervalTimer.expired()) {
-    inputIntervalTimer.restart();
-    // Decrease the startUpPhase variable, till it becomes zero
-    if (startUpPhase > 0) startUpPhase--;
-    // Check if we need to change the DIR register of an input port
-    if (dipSwitches.dip1setting == MELDEN) {port[0].check(0, POORT0_IN_REGISTER);}
-    if (dipSwitches.dip2setting == MELDEN) {port[1].check(1, POORT1_IN_REGISTER);}
-    if (dipSwitches.dip3setting == MELDEN) {port[2].check(2, POORT2_IN_REGISTER);}
+}
+
+
+void taskInput() {
+  // Check for each port that is configured as input if one or more input pins changed.
+  // The samples are taken by the sampler ISR at certain intervals (default: 10 ms); we process
+  // all samples that were taken since the previous run.
+  uint8_t sample[3];
+  while (sampler.read(sample)) {
+    LOG_SAMPLE(sample, sampler.time);
+    if (dipSwitches.hasInputs(poort0::nr)) {
+      port[poort0::nr].check(sample[poort0::nr], ~dipSwitches.outputs[poort0::nr]);
+    }
+    if (dipSwitches.hasInputs(poort1::nr)) {
+      port[poort1::nr].check(sample[poort1::nr], ~dipSwitches.outputs[poort1::nr]);
+    }
+    if (dipSwitches.hasInputs(poort2::nr)) {
+      port[poort2::nr].check(sample[poort2::nr], ~dipSwitches.outputs[poort2::nr]);
+    }
+    // Links let an input result drive an output, within the same sample
+    links.check();
   }
-  // Step 4: As frequent as possible we have to check for each RS-Bus connection if the buffer 
+  links.update();
+  // In event mode sampling may stop if all inputs are stable. An input edge restarts sampling.
+  // In adaptive mode, sampling is fast while inputs are being debounced, and slow thereafter.
+  if ((!dipSwitches.hasInputs(poort0::nr) || port[poort0::nr].settled) &&
+     (!dipSwitches.hasInputs(poort1::nr) || port[poort1::nr].settled) &&
+     (!dipSwitches.hasInputs(poort2::nr) || port[poort2::nr].settled)) sampler.idle();
+    else sampler.busy();
+}
+
+
+void taskFeedback() {
+  // As frequent as possible we have to check for each RS-Bus connection if the buffer 
   // contains feedback data, and the ISR is ready to send that data via the UART. 
   // If necessary, we also (re)connect after a decoder (re)start or after a RS-Bus error.
-  // To prevent us from sending instable values during startup, we wait till that phase is over.
-  if (!startUpPhase) {
-    if (dipSwitches.dip1setting == MELDEN) {feedback[0].check(0);}
-    if (dipSwitches.dip2setting == MELDEN) {feedback[1].check(1);}
-    if (dipSwitches.dip3setting == MELDEN) {feedback[2].check(2);}
-  }
-  // Step 5: as frequent as possible we should check if the programming button is pushed and if
+  // To prevent us from sending instable values during startup, we wait till the inputs of a port
+  // are stable (see input.h), or are restored from EEPROM.
+  // New changes of all connections are handed over first, resyncs thereafter (see rsBus.h).
+  boolean report0 = dipSwitches.hasInputs(poort0::nr) ? port[poort0::nr].stable : RSCommon.echoOutputs;
+  boolean report1 = dipSwitches.hasInputs(poort1::nr) ? port[poort1::nr].stable : RSCommon.echoOutputs;
+  boolean report2 = dipSwitches.hasInputs(poort2::nr) ? port[poort2::nr].stable : RSCommon.echoOutputs;
+  if (report0) feedback0.sendChanges();
+  if (report1) feedback1.sendChanges();
+  if (report2) feedback2.sendChanges();
+  if (report0) feedback0.maintain();
+  if (report1) feedback1.maintain();
+  if (report2) feedback2.maintain();
+}
+
+
+void taskHardware() {
+  // As frequent as possible we should check if the programming button is pushed and if
   // the status of the onboard LED should be changed. We also check the RS-Bus polling routine,
   // which resets the RS-Bus counter after all 128 decoders have been polled.  
   // In addition, we check if PoM feedback messages should be returned via the RS-Bus (address 128).
   decoderHardware.update();
+  virtualCVs.check();
+  LOG_DRAIN();                       // print logged events, if the UART has room for them
+}
+
+
+void taskDip() {
+  // Read the DIP switch settings, and (re)configure DIR of the AVR output ports if needed
+  dipSwitches.check();
+}
+
+
+void taskHousekeeping() {
   RSCommon.checkLed();               // do we have a valid RS-Bus signal?
-  // Step XXX: For testing purposes: send periodic transmission of RS-Bus messages
+  persist.update();                  // writes at most one EEPROM byte per run
+  // For testing purposes: send periodic transmission of RS-Bus messages
 //  RSCommon.test(2);  
+}
+
+
+// The order of the table is the priority. Deadlines are in ms since the previous run of that task.
+// The index in the table is the task number of the profiler (CV200) and the deadline misses (CV253)
+const task_t tasks[TASKS] = {
+  // run               period  deadline
+  {taskDcc,            0,      5},                       // 0
+  {taskInput,          0,      10},                      // 1
+  {taskFeedback,       0,      RS_FEEDBACK_DEADLINE},    // 2
+  {taskHardware,       0,      5},                       // 3
+  {taskDip,            100,    200},                     // 4
+  {taskHousekeeping,   10,     50},                      // 5
+};
+
+
+//******************************************************************************************************
+void loop() { 
+  scheduler.run();
 }   
@@ -2,6 +2,15 @@
 // File:      dccIn.cpp
 // Author:    Aiko Pras
 // History:   2024/04/26 AP Version 1.0
+//            2026/10/17 agent Version 1.1: accessory commands are dispatched via a table, one register write per command
+//            2026/10/17 agent Version 1.2: PoM reads of read-only CVs are answered by virtualCVs
+//            2026/10/17 agent Version 1.3: accessory commands are logged via the logger
+//            2026/10/17 agent Version 1.4: repeated accessory commands are suppressed (shadow of the outputs)
+//            2026/10/17 agent Version 1.5: pulsed outputs (pulses.h); setOutput() handles one IO pin
+//            2026/10/17 agent Version 1.6: routes: one accessory address sets a stored pattern of outputs
+//            2026/10/17 agent Version 1.7: extended accessory packets set all outputs of a POORT
+//            2026/10/17 agent Version 1.8: inputs and outputs on one POORT (Dir_Override, Dir_Mask)
+//            2026/10/17 agent Version 1.9: LOG_LEVEL 3 traces all accessory packets (logger.h)
 // 
 // Purpose:   Handling the accessory (switch commands)
 // 
@@ -10,6 +19,9 @@
 #include "hardware.h"                 // Pin assignments and #defines
 #include "myDefaults.h"               // Default values for this specific board
 #include "dipSwitches.h"              // The three switches that determine MELDEN or SCHAKELEN
+#include "logger.h"                   // Non-blocking logging
+#include "pulses.h"                   // Outputs that return to LOW by themselves
+#include "virtualCVs.h"               // Read-only CVs that reflect the decoder state
 #include "dccIn.h"
 
 unsigned int firstDecoderAddress;     // Derived from CV1 + CV9 (1..511)
@@ -19,14 +31,6 @@ DccTimer AccLedTimer;                 // To switch the LED off that signals the
 
 
 // ******************************************************************************************************
-void dcc_in_class::print_details(uint8_t pin) {
-  Serial.print("I/O pin: ");
-  Serial.print(pin);
-  if (accCmd.position == 1) Serial.println(" +");
-    else Serial.println(" -");
-}
-
-
 void dcc_in_class::init() {
   // Step 1: Set CV default values (see CvValues.h. for details) 
   // Decoder type (DecType) and software version (version) are set using cvValues.init().
@@ -40,204 +44,165 @@ void dcc_in_class::init() {
   // For 24 IO pins, we need to listen to 6 decoder addresses
   firstDecoderAddress = cvValues.storedAddress();
   accCmd.setMyAddress(firstDecoderAddress, firstDecoderAddress + 5);
+  // Read the pulse duration of each output
+  pulses.init();
+  // Routes: a block of two extra decoder addresses, and per route the outputs to change
+  routeAddress = cvValues.read(Route_Address) + (cvValues.read(Route_Address + 1) << 8);
+  // A mask of 255 is erased EEPROM, and changes no outputs. Thus an unused route changes nothing
+  for (uint8_t r = 0; r < ROUTES; r++) {
+    for (uint8_t p = 0; p < 3; p++) {
+      uint8_t setMask = cvValues.read(Route_Table + 6 * r + p);
+      uint8_t clearMask = cvValues.read(Route_Table + 6 * r + 3 + p);
+      routeSet[r][p] = (setMask == 255) ? 0 : setMask;
+      routeClear[r][p] = (clearMask == 255) ? 0 : clearMask;
+    }
+  }
+  // Extended accessory packets: three consecutive addresses, one for each POORT
+  extAddress = cvValues.read(Ext_Address) + (cvValues.read(Ext_Address + 1) << 8);
+  extBitOrder = cvValues.read(Ext_Bit_Order);
   // We will also listen to PoM messages. As address we use an offset plus the RS Address
   uint16_t myPomAddress = cvValues.read(Offset_PoM) * 100 + cvValues.read(myRSAddr);
   locoCmd.setMyAddress(myPomAddress);
 }
 
 
+// ******************************************************************************************************
+boolean dcc_in_class::setOutput(uint8_t IO_pin, uint8_t position) {
+  // Lookup the associated AVR port and bit, and write if that pin is an output (SCHAKELEN)
+  // Returns true if the output is changed, false if not allowed or if it is a repeated command
+  const ioPinMap_t &map = ioPinMap[IO_pin - 1];
+  if (!(dipSwitches.outputs[map.poort] & map.bitMask)) return false;
+  uint8_t level = (position == HIGH) ? map.bitMask : 0;
+  if (level && pulses.duration(IO_pin)) {
+    // A pulsed output: it returns to LOW by itself. Repeats during the pulse are suppressed
+    commandedKnown[map.poort] &= ~map.bitMask;
+    if (pulses.active(IO_pin)) {
+      if (suppressed < 0xFFFF) suppressed++;
+      return false;
+    }
+    poortRegisters[map.poort]->OUTSET = map.bitMask;
+    pulses.start(IO_pin);
+  }
+  else if ((commandedKnown[map.poort] & map.bitMask) &&
+          ((commandedLevel[map.poort] & map.bitMask) == level)) {
+    // A repeat of a command we already executed
+    if (suppressed < 0xFFFF) suppressed++;
+    return false;
+  }
+  else {
+    if (level) poortRegisters[map.poort]->OUTSET = map.bitMask;
+      else {
+        pulses.cancel(IO_pin);
+        poortRegisters[map.poort]->OUTCLR = map.bitMask;
+      }
+    commandedKnown[map.poort] |= map.bitMask;
+    commandedLevel[map.poort] = (commandedLevel[map.poort] & ~map.bitMask) | level;
+  }
+  if (applied < 0xFFFF) applied++;
+  return true;
+}
+
+
+boolean dcc_in_class::writePoort(uint8_t p, uint8_t set, uint8_t clear) {
+  // Sets and clears multiple outputs of a POORT with a single write to its OUT register.
+  // Only pins that are output (SCHAKELEN) are changed. Returns true if one or more outputs changed
+  set &= dipSwitches.outputs[p];
+  clear &= dipSwitches.outputs[p];
+  if (!(set | clear)) return false;
+  // Running pulses would end an output that is set; these outputs are latched
+  for (uint8_t j = 0; j < 8; j++) {
+    if (bitRead(set | clear, 7 - j)) pulses.cancel(p * 8 + j + 1);
+  }
+  boolean changed = false;
+  uint8_t oldSREG = SREG;
+  cli();                                 // the pulse ISR may also write to OUT
+  uint8_t oldValue = poortRegisters[p]->OUT;
+  uint8_t newValue = (oldValue | set) & ~clear;
+  if (newValue != oldValue) {
+    poortRegisters[p]->OUT = newValue;
+    changed = true;
+  }
+  SREG = oldSREG;
+  commandedKnown[p] |= set | clear;
+  commandedLevel[p] = (commandedLevel[p] | set) & ~clear;
+  return changed;
+}
+
+
+boolean dcc_in_class::setRoute(uint8_t route) {
+  // The outputs of a route change with at most one write to the OUT register of each POORT.
+  // The POORTs are written one after another, each under its own cli(), thus not as one atomic set.
+  // Returns true if one or more outputs changed
+  boolean changed = false;
+  for (uint8_t p = 0; p < 3; p++) {
+    if (writePoort(p, routeSet[route][p], routeClear[route][p])) changed = true;
+  }
+  if (changed) {if (applied < 0xFFFF) applied++;}
+    else {if (suppressed < 0xFFFF) suppressed++;}
+  return changed;
+}
+
+
+boolean dcc_in_class::checkExtendedAccessory() {
+  // Extended accessory packet: {10AAAAAA} {0AAA0AA1} {XXXXXXXX} {error detection byte}
+  // Returns true if it is an extended accessory packet for one of our POORTs
+  if (!extAddress || (dccMessage.size != 4)) return false;
+  uint8_t byte0 = dccMessage.data[0];
+  uint8_t byte1 = dccMessage.data[1];
+  if (((byte0 & 0xC0) != 0x80) || ((byte1 & 0x89) != 0x01)) return false;
+  unsigned int address = ((~byte1 & 0x70) << 4) | ((byte0 & 0x3F) << 2) | ((byte1 & 0x06) >> 1);
+  if ((address < extAddress) || (address >= extAddress + 3)) return false;
+  uint8_t p = address - extAddress;
+  uint8_t value = dccMessage.data[2];
+  // Aspect bit 0 goes to the first IO pin of the POORT, which is bit 7 of the AVR port
+  if (!extBitOrder) value = reverseBits(value);
+  if (writePoort(p, value, ~value)) {
+    if (applied < 0xFFFF) applied++;
+    digitalWriteFast(LED_ACC, HIGH);
+    AccLedTimer.setTime(1000);
+    LOG_EXTENDED(p, dccMessage.data[2]);
+  }
+  else if (dipSwitches.outputs[p]) {
+    if (suppressed < 0xFFFF) suppressed++;
+  }
+  return true;
+}
+
+
 void dcc_in_class::check() {
   unsigned int IO_pin;                  // IO pin at which this DCC command is aimed (1..24)
   if (dcc.input()) {    
+    // Trace all accessory packets, basic as well as extended: the first byte is 10AAAAAA
+    if ((dccMessage.data[0] & 0xC0) == 0x80) {LOG_DCC();}
     // Step 1: Is the received DCC message intended for me?
-    if (dcc.cmdType == Dcc::MyAccessoryCmd) {
+    // Extended accessory packets write all 8 outputs of a POORT at once
+    if (checkExtendedAccessory()) {}
+    else if (dcc.cmdType == Dcc::MyAccessoryCmd) {
       // To what I/O pin is it directed and is it ON (+) or OFF (-)
       IO_pin = (accCmd.decoderAddress - firstDecoderAddress) * 4 + accCmd.turnout;
       boolean react = false; 
-      switch (IO_pin) {        
-        // POORT0
-        case 1: 
-          if (dipSwitches.dip1setting == SCHAKELEN) {
-            react = true;
-            if (accCmd.position == HIGH) digitalWriteFast(POORT0_1, HIGH);
-              else digitalWriteFast(POORT0_1, LOW);
-          }
-        break;
-        case 2: 
-          if (dipSwitches.dip1setting == SCHAKELEN) {
-            react = true;
-            if (accCmd.position == HIGH) digitalWriteFast(POORT0_2, HIGH);
-              else digitalWriteFast(POORT0_2, LOW);
-          }
-        break;
-        case 3: 
-          if (dipSwitches.dip1setting == SCHAKELEN) {
-            react = true;
-            if (accCmd.position == HIGH) digitalWriteFast(POORT0_3, HIGH);
-              else digitalWriteFast(POORT0_3, LOW);
-          }
-        break;
-        case 4: 
-          if (dipSwitches.dip1setting == SCHAKELEN) {
-            react = true;
-            if (accCmd.position == HIGH) digitalWriteFast(POORT0_4, HIGH);
-              else digitalWriteFast(POORT0_4, LOW);
-          }
-        break;
-        case 5: 
-          if (dipSwitches.dip1setting == SCHAKELEN) {
-            react = true;
-            if (accCmd.position == HIGH) digitalWriteFast(POORT0_5, HIGH);
-              else digitalWriteFast(POORT0_5, LOW);
-          }
-        break;
-        case 6: 
-          if (dipSwitches.dip1setting == SCHAKELEN) {
-            react = true;
-            if (accCmd.position == HIGH) digitalWriteFast(POORT0_6, HIGH);
-              else digitalWriteFast(POORT0_6, LOW);
-          }
-        break;
-        case 7: 
-          if (dipSwitches.dip1setting == SCHAKELEN) {
-            react = true;
-            if (accCmd.position == HIGH) digitalWriteFast(POORT0_7, HIGH);
-              else digitalWriteFast(POORT0_7, LOW);
-          }
-        break;
-        case 8: 
-          if (dipSwitches.dip1setting == SCHAKELEN) {
-            react = true;
-            if (accCmd.position == HIGH) digitalWriteFast(POORT0_8, HIGH);
-              else digitalWriteFast(POORT0_8, LOW);
-          }
-        break;
-        // POORT1
-        case 9: 
-          if (dipSwitches.dip2setting == SCHAKELEN) {
-            react = true;
-            if (accCmd.position == HIGH) digitalWrite(POORT1_1, HIGH);
-              else digitalWrite(POORT1_1, LOW);
-          }
-        break;
-        case 10: 
-          if (dipSwitches.dip2setting == SCHAKELEN) {
-            react = true;
-            if (accCmd.position == HIGH) digitalWriteFast(POORT1_2, HIGH);
-              else digitalWriteFast(POORT1_2, LOW);
-          }
-        break;
-        case 11: 
-          if (dipSwitches.dip2setting == SCHAKELEN) {
-            react = true;
-            if (accCmd.position == HIGH) digitalWriteFast(POORT1_3, HIGH);
-              else digitalWriteFast(POORT1_3, LOW);
-          }
-        break;
-        case 12: 
-          if (dipSwitches.dip2setting == SCHAKELEN) {
-            react = true;
-            if (accCmd.position == HIGH) digitalWriteFast(POORT1_4, HIGH);
-              else digitalWriteFast(POORT1_4, LOW);
-          }
-        break;
-        case 13: 
-          if (dipSwitches.dip2setting == SCHAKELEN) {
-            react = true;
-            if (accCmd.position == HIGH) digitalWriteFast(POORT1_5, HIGH);
-              else digitalWriteFast(POORT1_5, LOW);
-          }
-        break;
-        case 14: 
-          if (dipSwitches.dip2setting == SCHAKELEN) {
-            react = true;
-            if (accCmd.position == HIGH) digitalWriteFast(POORT1_6, HIGH);
-              else digitalWriteFast(POORT1_6, LOW);
-          }
-        break;
-        case 15: 
-          if (dipSwitches.dip2setting == SCHAKELEN) {
-            react = true;
-            if (accCmd.position == HIGH) digitalWriteFast(POORT1_7, HIGH);
-              else digitalWriteFast(POORT1_7, LOW);
-          }
-        break;
-        case 16: 
-          if (dipSwitches.dip2setting == SCHAKELEN) {
-            react = true;
-            if (accCmd.position == HIGH) digitalWriteFast(POORT1_8, HIGH);
-              else digitalWriteFast(POORT1_8, LOW);
-          }
-        break;
-        // POORT2
-        case 17: 
-          if (dipSwitches.dip3setting == SCHAKELEN) {
-            react = true;
-            if (accCmd.position == HIGH) digitalWrite(POORT2_1, HIGH);
-              else digitalWrite(POORT2_1, LOW);
-          }
-        break;
-        case 18: 
-          if (dipSwitches.dip3setting == SCHAKELEN) {
-            react = true;
-            if (accCmd.position == HIGH) digitalWriteFast(POORT2_2, HIGH);
-              else digitalWriteFast(POORT2_2, LOW);
-          }
-        break;
-        case 19: 
-          if (dipSwitches.dip3setting == SCHAKELEN) {
-            react = true;
-            if (accCmd.position == HIGH) digitalWriteFast(POORT2_3, HIGH);
-              else digitalWriteFast(POORT2_3, LOW);
-          }
-        break;
-        case 20: 
-          if (dipSwitches.dip3setting == SCHAKELEN) {
-            react = true;
-            if (accCmd.position == HIGH) digitalWriteFast(POORT2_4, HIGH);
-              else digitalWriteFast(POORT2_4, LOW);
-          }
-        break;
-        case 21: 
-          if (dipSwitches.dip3setting == SCHAKELEN) {
-            react = true;
-            if (accCmd.position == HIGH) digitalWriteFast(POORT2_5, HIGH);
-              else digitalWriteFast(POORT2_5, LOW);
-          }
-        break;
-        case 22: 
-          if (dipSwitches.dip3setting == SCHAKELEN) {
-            react = true;
-            if (accCmd.position == HIGH) digitalWriteFast(POORT2_6, HIGH);
-              else digitalWriteFast(POORT2_6, LOW);
-          }
-        break;
-        case 23: 
-          if (dipSwitches.dip3setting == SCHAKELEN) {
-           react = true;
-           if (accCmd.position == HIGH) digitalWriteFast(POORT2_7, HIGH);
-              else digitalWriteFast(POORT2_7, LOW);
-          }
-        break;
-        case 24: 
-          if (dipSwitches.dip3setting == SCHAKELEN) {
-            react = true;
-            if (accCmd.position == HIGH) digitalWriteFast(POORT2_8, HIGH);
-              else digitalWriteFast(POORT2_8, LOW);
-          }
-        break;
-        default:
-        break;
-      };
+      if ((IO_pin >= 1) && (IO_pin <= 24)) react = setOutput(IO_pin, accCmd.position);
       // Turn the ACC LED on, to indicate we have reacted on the accesory message
       if (react) {
         digitalWriteFast(LED_ACC, HIGH);
         AccLedTimer.setTime(1000);
-        print_details(IO_pin);
+        LOG_ACC(IO_pin, accCmd.position);
+      }
+    }
+    else if ((dcc.cmdType == Dcc::AnyAccessoryCmd) && routeAddress &&
+             (accCmd.decoderAddress >= routeAddress) && (accCmd.decoderAddress < routeAddress + ROUTES / 4)) {
+      // A "+" command for one of the route addresses
+      uint8_t route = (accCmd.decoderAddress - routeAddress) * 4 + accCmd.turnout - 1;
+      if ((accCmd.position == HIGH) && setRoute(route)) {
+        digitalWriteFast(LED_ACC, HIGH);
+        AccLedTimer.setTime(1000);
+        LOG_ROUTE(route + 1);
       }
     }
     else { // PoM or SM programming??
-      if (dcc.cmdType == Dcc::MyPomCmd) cvProgramming.processMessage(Dcc::MyPomCmd);
+      if (dcc.cmdType == Dcc::MyPomCmd) {
+        if (!virtualCVs.handled()) cvProgramming.processMessage(Dcc::MyPomCmd);
+      }
       else if (dcc.cmdType == Dcc::SmCmd) cvProgramming.processMessage(Dcc::SmCmd);
     };
     // Step 2: Turn the DCC LED on, to indicate the DCC signal is valid
@@ -2,18 +2,42 @@
 // File:      dccIn.h
 // Author:    Aiko Pras
 // History:   2024/04/26 AP Version 1.0
+//            2026/10/17 agent Version 1.1: accessory commands are logged via the logger
+//            2026/10/17 agent Version 1.2: repeated accessory commands are suppressed (shadow of the outputs)
+//            2026/10/17 agent Version 1.3: pulsed outputs (pulses.h); setOutput() handles one IO pin
+//            2026/10/17 agent Version 1.4: routes: one accessory address sets a stored pattern of outputs
+//            2026/10/17 agent Version 1.5: extended accessory packets set all outputs of a POORT
+//            2026/10/17 agent Version 1.6: setOutput() is also used by the links
 // 
 // Purpose:   Handling the incoming accessory (switch commands)
 // 
 // *******************************************************************************************************
 #pragma once
+#include "extraCVs.h"                  // Numbers of the CVs not defined by AP_DCC_Decoder_Core
 
 class dcc_in_class {
   public:
     void init();
     void check();
     void checksave();
-    void print_details(uint8_t pin);   // For testing purposes
+    boolean setOutput(uint8_t IO_pin, uint8_t position);   // IO_pin = 1..24, position = HIGH / LOW
+    boolean setRoute(uint8_t route);                       // route = 0..ROUTES-1
+    boolean writePoort(uint8_t p, uint8_t set, uint8_t clear); // p = POORT, set / clear = AVR bitmasks
+
+    // Command stations repeat accessory commands. Repeats for outputs that already have the commanded
+    // level are suppressed: the pin, the ACC LED and the log are not touched again.
+    uint16_t applied;                  // Number of accessory commands that changed an output
+    uint16_t suppressed;               // Number of accessory commands that were a repeat
+
+  private:
+    uint8_t commandedLevel[3];         // Per POORT: the level of the last command for each pin
+    uint8_t commandedKnown[3];         // Per POORT: the pins for which a command was received
+    unsigned int routeAddress;         // First decoder address for routes (0 = no routes)
+    uint8_t routeSet[ROUTES][3];       // Copy of the Route_Table CVs: outputs to make HIGH
+    uint8_t routeClear[ROUTES][3];     // Outputs to make LOW
+    unsigned int extAddress;           // Extended accessory address of POORT0 (0 = not used)
+    uint8_t extBitOrder;               // 0 = aspect bit 0 is IO pin 1, 1 = aspect is written as is
+    boolean checkExtendedAccessory();
 };
 
 
@@ -2,13 +2,22 @@
 // File:      dipSwitches.cpp
 // Author:    Aiko Pras
 // History:   2024/04/27 AP Version 1.0
+//            2026/10/17 agent Version 1.1: the POORTs are set to input or output with one register write
+//            2026/10/17 agent Version 1.2: pin change interrupts for the MELDEN POORTs (event mode)
+//            2026/10/17 agent Version 1.3: DIP switch changes are logged via the logger
+//            2026/10/17 agent Version 1.4: one template handles the switch of each POORT
+//            2026/10/17 agent Version 1.5: inputs and outputs on one POORT (Dir_Override, Dir_Mask)
 // 
 // Purpose:   Read the DIP switches and (re)configure the outputs if needed 
 // 
 // *******************************************************************************************************
 #include <Arduino.h>                  // For general definitions
+#include <AP_DCC_Decoder_Core.h>      // To include all objects, such as dcc, accCmd, etc.
 #include "hardware.h"                 // Pin assignments and #defines
+#include "extraCVs.h"                 // Numbers of the CVs not defined by AP_DCC_Decoder_Core
 #include "dipSwitches.h"
+#include "sampler.h"                  // Pin change interrupts are only needed for MELDEN ports
+#include "logger.h"                   // Non-blocking logging
 
 dipSwitchClass dipSwitches;           // Instantiate the object vor the 3 DIP switches
 
@@ -18,60 +27,49 @@ void dipSwitchClass::init() {
   pinMode(DIP_SWITCH_1, INPUT_PULLUP);   // initialise as input (MELDEN)
   pinMode(DIP_SWITCH_2, INPUT_PULLUP);
   pinMode(DIP_SWITCH_3, INPUT_PULLUP);
-  dip1setting = MELDEN;                  // initialise as MELDEN (input)
-  dip2setting = MELDEN;
-  dip3setting = MELDEN;
-  POORT0_IS_MELDEN;                      // set the DIR register of the associated AVR PORT
-  POORT1_IS_MELDEN;
-  POORT2_IS_MELDEN;
+  dipSettings = 0b111;                   // initialise as MELDEN (input)
+  // CV43 is 255 in erased EEPROM. That would make all 24 pins outputs, thus it means "not set"
+  dirOverride = cvValues.read(Dir_Override);
+  dirOverride = (dirOverride == 255) ? 0 : dirOverride & 0b111;
+  // set the DIR register of the associated AVR PORT. Either from CV or as MELDEN
+  setDirection<poort0>(bitRead(dirOverride, poort0::nr) ? cvValues.read(Dir_Mask + poort0::nr) : 0x00);
+  setDirection<poort1>(bitRead(dirOverride, poort1::nr) ? cvValues.read(Dir_Mask + poort1::nr) : 0x00);
+  setDirection<poort2>(bitRead(dirOverride, poort2::nr) ? cvValues.read(Dir_Mask + poort2::nr) : 0x00);
   // Check each of the three DIP switches 
   check();
 }
 
 
-void dipSwitchClass::check() {
-  uint8_t newValue;
-  // Check DIP switch 1
-  newValue = digitalReadFast(DIP_SWITCH_1);  
-  if (newValue != dip1setting) {
-    dip1setting = newValue;    // set the boolean flag to facilitate detection of changes
-    if (dip1setting == MELDEN) {
-      Serial.println("DIP switch 1: Melden");
-      POORT0_IS_MELDEN;        // set the DIR register of the associated AVR PORT
-    }
-    else {
-      Serial.println("DIP switch 1: Schakelen");
-      POORT0_IS_SCHAKELEN;     // set the DIR register of the associated AVR PORT
-    }
-  }
-  // Check DIP switch 2
-  newValue = digitalReadFast(DIP_SWITCH_2);  
-  if (newValue != dip2setting) {
-    dip2setting = newValue;
-    if (dip2setting == MELDEN) {
-      Serial.println("DIP switch 2: Melden");
-      POORT1_IS_MELDEN;        // set the DIR register of the associated AVR PORT
-    }
-    else {
-      Serial.println("DIP switch 2: Schakelen");
-      POORT1_IS_SCHAKELEN;
-    }
+template <class POORT> void dipSwitchClass::setDirection(uint8_t value) {
+  outputs[POORT::nr] = value;
+  POORT::vport().DIR = value;            // set the DIR register of the associated AVR PORT
+  sampler.setEdgeDetection<POORT>(~value);
+}
+
+
+template <class POORT> void dipSwitchClass::checkSwitch() {
+  if (bitRead(dirOverride, POORT::nr)) return;
+  uint8_t newValue = digitalReadFast(POORT::dipPin);
+  if (newValue == bitRead(dipSettings, POORT::nr)) return;
+  if (newValue == MELDEN) {
+    bitSet(dipSettings, POORT::nr);
+    LOG_DIP(POORT::nr + 1, MELDEN);
+    setDirection<POORT>(0x00);
   }
-  // Check DIP switch 3
-  newValue = digitalReadFast(DIP_SWITCH_3);  
-  if (newValue != dip3setting) {
-    dip3setting = newValue;
-    if (dip3setting == MELDEN) {
-      Serial.println("DIP switch 3: Melden");
-      POORT2_IS_MELDEN;        // set the DIR register of the associated AVR PORT
-    }
-    else {
-      Serial.println("DIP switch 3: Schakelen");
-      POORT2_IS_SCHAKELEN;
-    }
+  else {
+    bitClear(dipSettings, POORT::nr);
+    LOG_DIP(POORT::nr + 1, SCHAKELEN);
+    setDirection<POORT>(0xFF);
   }
 }
 
+
+void dipSwitchClass::check() {
+  checkSwitch<poort0>();
+  checkSwitch<poort1>();
+  checkSwitch<poort2>();
+}
+
 /*
 void dipSwitchClass::print() {
   if (digitalReadFast(DIP_SWITCH_1)) {Serial.println("DIP swich 1 = Melden");}
@@ -2,9 +2,16 @@
 // File:      dipSwitches.h
 // Author:    Aiko Pras
 // History:   2024/04/27 AP Version 1.0
+//            2026/10/17 agent Version 1.1: the POORTs are set to input or output with one register write
+//            2026/10/17 agent Version 1.2: one template handles the switch of each POORT
+//            2026/10/17 agent Version 1.3: inputs and outputs on one POORT (Dir_Override, Dir_Mask)
+//            2026/10/17 agent Version 1.4: state(): the DIP switches and Dir_Override, for the snapshot CVs
 // 
 // Purpose:   Read the DIP switches and (re)configure the outputs if needed 
 //            These are the 3 red switches, that can either be "schakelen" or "melden"
+//
+// Instead of the DIP switch, CV44..CV46 (Dir_Mask) may determine the direction of each individual 
+// pin of a POORT. This is the case for the POORTs whose bit is set in CV43 (Dir_Override).
 // 
 // *******************************************************************************************************
 #pragma once
@@ -13,13 +20,22 @@
 
 class dipSwitchClass {
   public:
-    void init();           // Configure the three DIP switch pins as input with pull-up
+    void init();           // Configure the three DIP switch pins as input with pull-up. Reads CV43..46,
+                           // thus should be called after dcc_in.init() has initialised cvValues
     void check();          // Checks if a DIP switch has changed, and store the associate POORT DIR
 //    void print();          // For testing. May be removed
+    boolean hasInputs(uint8_t poort) {return (outputs[poort] != 0xFF);}
+    uint8_t state() {return dipSettings | (dirOverride << 4);}   // Bit 0..2: MELDEN, 4..6: override
 
-    boolean dip1setting;   // We store the setting of the three DIP switches,
-    boolean dip2setting;   // to allow detection of state and changes
-    boolean dip3setting;
+    uint8_t outputs[3];    // Per POORT the value of the DIR register: a bit is set for each output 
+                           // (SCHAKELEN) pin, and clear for each input (MELDEN) pin
+
+  private:
+    uint8_t dipSettings;   // We store the setting of the three DIP switches, to allow detection of
+                           // changes: bit 0..2 is set if DIP switch 1..3 is MELDEN
+    uint8_t dirOverride;   // Copy of CV43: the POORTs for which the DIP switch is ignored
+    template <class POORT> void checkSwitch();
+    template <class POORT> void setDirection(uint8_t value);
 };
 
 
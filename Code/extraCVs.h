@@ -0,0 +1,131 @@
+//*****************************************************************************************************
+//
+// File:      extraCVs.h
+// Author:    agent
+// History:   2026/10/17 agent Version 1.0
+//
+// Purpose:   Numbers of the CVs that are used by this decoder, in addition to the CVs that are 
+//            defined for the TMC24ChannelIODecoder in the AP_DCC_Decoder_Core library (CV0..CV37).
+//            Default values for these CVs are set in myDefaults.cpp. 
+//
+//******************************************************************************************************
+#pragma once
+
+// CV38/CV39: Route_Address. Decoder address of the first of two accessory decoder addresses that 
+// select a route (see Route_Table). Low byte in CV38, high byte in CV39. 0 = no routes.
+// Route n (0..7) is selected by a "+" command to decoder address Route_Address + n / 4, turnout n % 4.
+#define Route_Address        38
+
+// CV40/CV41: Ext_Address. Address of the extended accessory (signal aspect) packets for POORT0; 
+// POORT1 and POORT2 use the next two addresses. Low byte in CV40, high byte in CV41. 0 = not used.
+// This is the 11-bit address as it is contained in the packet. Depending on the command station, 
+// the address shown to the user is this value + 1 or this value - 3.
+// The 8-bit aspect sets the output (SCHAKELEN) pins of the POORT.
+#define Ext_Address          40
+
+// CV42: Ext_Bit_Order. 0 = aspect bit 0 sets the first IO pin of the POORT, bit 7 the last IO pin
+//                      1 = the aspect is written unchanged to the OUT register of the AVR port
+#define Ext_Bit_Order        42
+
+// CV43: Dir_Override. Bit 0..2: if set, the direction of the pins of POORT0..2 is taken from
+// Dir_Mask, and the DIP switch of that POORT is ignored. This allows inputs and outputs on one POORT.
+// 255 (erased EEPROM) is treated as 0: all POORTs follow their DIP switch.
+#define Dir_Override         43
+
+// CV44..CV46: Dir_Mask for POORT0..2. Bit set = output (SCHAKELEN), bit clear = input (MELDEN).
+// The masks use the bit order of the AVR port: bit 7 is the first IO pin of that POORT.
+#define Dir_Mask             44
+
+// CV47: Output_Report. What the RS-Bus feedback reports for output pins
+// 0 = output pins are always reported as 0
+// 1 = output pins report their current level. POORTs without any input also send feedback then.
+#define Output_Report        47
+
+// CV48: Persist_Interval. Minimum time in seconds between two EEPROM writes of the input state
+// (see persist.h). 0 = the input state is not stored, and at startup all inputs are LOW.
+#define Persist_Interval     48
+
+// CV49: Fast_Interval. Adaptive rate only: ms between samples while an input is being debounced.
+#define Fast_Interval        49
+
+// CV50: Glitch_Filter. 0 = the debounce windows are fixed. 1..4 = the rise and fall windows of a pin
+// widen if its input has glitches, up to 2^CV50 times the value of its profile (see input.h).
+// CV51: Glitch_Threshold. Number of glitches within 256 samples before the window of a pin widens.
+#define Glitch_Filter        50
+#define Glitch_Threshold     51
+
+// CV52: Input_Mode. Determines how the input pins are sampled
+// - bit 0: 0 = fixed rate sampling, every Int_Samples ms
+//          1 = event mode: while all inputs are stable, sampling stops. The first edge on an 
+//              input pin (pin change interrupt) immediately restarts sampling.
+// - bit 1: 1 = adaptive rate: while an input is being debounced, samples are taken every 
+//              Fast_Interval (CV49) ms; once all inputs are stable, every Int_Samples ms.
+//              CV33, CV34 and CV36 keep their meaning in units of Int_Samples ms.
+#define Input_Mode           52
+#define INPUT_MODE_EVENT     0      // Bit number within Input_Mode
+#define INPUT_MODE_ADAPTIVE  1
+
+
+//******************************************************************************************************
+// Tables. CV64 and higher have no factory default: both 0 and 255 (erased EEPROM) mean "not used".
+
+// CV64..CV87: Pulse_Time. Minimum pulse duration for IO pin 1..24, in units of 10 ms (1..254).
+// The actual pulse is up to 10 ms longer (see pulses.h).
+// If set, a "+" accessory command makes the output HIGH, and the output returns to LOW by itself
+// after the pulse duration. If not used (0 or 255), the output keeps the commanded level.
+#define Pulse_Time           64     // CV for IO pin 1; IO pin n uses CV (Pulse_Time + n - 1)
+
+// CV88..CV135: Route_Table. 8 routes of 6 CVs each: the set masks for POORT0..2, followed by the 
+// clear masks for POORT0..2. The masks use the bit order of the AVR port: bit 7 is the first IO pin
+// of that POORT. Only output (SCHAKELEN) pins are changed. A mask of 0 or 255 (erased EEPROM) 
+// changes no outputs. Route n starts at CV (Route_Table + 6 * n).
+#define Route_Table          88
+#define ROUTES               8
+
+// CV136..CV159: Link_Table. 8 links of 3 CVs each, from an input pin to an output pin (see links.h):
+// - input IO pin (1..24). The link is not used if this CV is 0 or 255
+// - output IO pin (1..24). Add 128 to invert: the output is HIGH if the input is LOW
+// - delay in units of 10 ms (0..254). 0 = the output follows the input immediately
+// Link n starts at CV (Link_Table + 3 * n).
+#define Link_Table           136
+#define LINKS                8
+
+// CV160..CV183: Pin_Profile. Debounce profile (1..4) of IO pin 1..24. 0 or 255 = CV33 and CV34.
+// CV184..CV191: Profile_Table. Per profile the rise window (samples HIGH before the result becomes 1)
+// and the fall window (samples LOW before the result becomes 0), in units of Int_Samples ms.
+// Profile n uses CV (Profile_Table + 2 * (n - 1)) and the next CV.
+#define Pin_Profile          160
+#define Profile_Table        184
+#define PROFILES             4
+
+
+//******************************************************************************************************
+// Read-only CVs. These are not stored, but reflect the internal state of the decoder.
+// They can be read via PoM; see virtualCVs.h for details. Some of these CVs select what the
+// other CVs return. Such select CVs can be written via PoM; all other writes are ignored.
+
+// CV200..CV228: Duration of the tasks in loop(). Only available if PROFILING is defined
+#define Prof_Select          200    // Task (0..TASKS-1) that CV201..CV228 return. Writing 255 resets
+#define Prof_Last            228
+
+// CV230..CV239: Snapshot of the decoder state. Each CV is one byte in the bit order of the AVR port:
+// bit 7 is the first IO pin of that POORT. Six reads return all 24 inputs and outputs.
+#define Snap_In              230    // CV230..CV232: IN register of POORT0..2 (the raw pin levels)
+#define Snap_Out             233    // CV233..CV235: OUT register of POORT0..2
+#define Snap_Result          236    // CV236..CV238: debounced results of POORT0..2
+#define Snap_Dip             239    // Bit 0..2: DIP switch 1..3 is MELDEN. Bit 4..6: Dir_Override
+
+// CV240..CV243: Accessory commands that changed an output (applied) and repeats that were suppressed 
+#define Acc_Applied          240    // Low byte first (CV240, CV241)
+#define Acc_Suppressed       242    // Low byte first (CV242, CV243)
+
+// CV244..CV252: Diagnostic counters of a single input pin (see input.h). Low byte first.
+#define Diag_Select          244    // IO pin (1..24) that CV245..CV252 return. Writing 255 resets all
+#define Diag_Edges           245    // Samples that differ from the previous sample
+#define Diag_Spikes          247    // Short HIGH pulses, filtered by the rise window
+#define Diag_HoldOffs        249    // Short LOW pulses, absorbed by the fall window
+#define Diag_Transitions     251    // Changes of the debounced result
+
+// CV253..CV255: Deadline misses of the tasks of loop() (see scheduler.h). Low byte first.
+#define Sched_Select         253    // Task (0..TASKS-1) that CV254/CV255 return. Writing 255 resets all
+#define Sched_Misses         254
@@ -2,6 +2,7 @@
 // File:      hardware.cpp
 // Author:    Aiko Pras
 // History:   2024/04/26 AP Version 1.0
+//            2026/10/17 agent Version 1.1: the outputs are set with one register write per POORT
 // 
 // Purpose:   To initialise the LEDs and associated timers
 //
@@ -10,6 +11,8 @@
 #include <AP_DCC_Decoder_Core.h>      // To include all objects, such as dcc, accCmd, etc.
 #include "hardware.h"
 
+PORT_t * const poortRegisters[3] = {&PORTD, &PORTC, &PORTB};
+
 
 void ledClass::init() {
   pinMode(LED_DCC, OUTPUT);
@@ -2,6 +2,12 @@
 // File:      hardware.h
 // Author:    Aiko Pras
 // History:   2024/04/26 AP Version 1.0
+//            2026/10/17 agent Version 1.1: TCA0 is used for input sampling
+//            2026/10/17 agent Version 1.2: table of the IO pins (ioPinMap) and register access per POORT
+//            2026/10/17 agent Version 1.3: Arduino pin of bit 0 of each POORT
+//            2026/10/17 agent Version 1.4: constexpr descriptors poort0..2 replace the POORTx macros
+//            2026/10/17 agent Version 1.5: the TCA0 interrupt also ends the pulsed outputs
+//            2026/10/17 agent Version 1.6: reverseBits(), shared by the extended accessory packets and the RS-Bus
 // 
 // Purpose:   Pin definitions for the TMC 24-Channel AVR64DA64 IO board
 // 
@@ -21,6 +27,8 @@
 // TCB1: Reserved for Servo Lib
 // TCB2: DxCore default for millis()
 // TCB3: RSBus library
+// TCA0: Input sampler and pulsed outputs (1 ms tick, see sampler.cpp). Taken over from DxCore,
+//       thus no PWM via TCA0
 //
 // ******************************************************************************************************
 #pragma once
@@ -46,45 +54,63 @@
 // The 24 pins of the 25 pin SUBD connector are connected to the following AVR128DA48 ports:
 // 1..8 = PORTD, 9..16 = PORTC and 17..24 = PORTB. 
 // To avoid confusion with names, we will use POORT0 for PORTD, POORT1 for POTC and POORT2 for PORTB.
-#define POORT0_IN_REGISTER  PORTD.IN
-#define POORT1_IN_REGISTER  PORTC.IN
-#define POORT2_IN_REGISTER  PORTB.IN
+// Each POORT is described by a struct with compile-time constants. Templates that take such struct
+// as parameter compile into straight-line code for that specific POORT, without array indexing.
+struct poort0 {
+  static constexpr uint8_t nr       = 0;               // index in port[], sample[] etc.
+  static constexpr uint8_t dipPin   = DIP_SWITCH_1;    // selects MELDEN or SCHAKELEN
+  static constexpr uint8_t firstPin = PIN_PD0;         // Arduino pin number of bit 0
+  static constexpr uint8_t rsOffset = 0;               // RS-Bus address = CV10 + rsOffset
+  static VPORT_t &vport() {return VPORTD;}
+};
 
-#define POORT0_IS_MELDEN    PORTD.DIR = 0x00
-#define POORT1_IS_MELDEN    PORTC.DIR = 0x00
-#define POORT2_IS_MELDEN    PORTB.DIR = 0x00
-#define POORT0_IS_SCHAKELEN PORTD.DIR = 0xFF
-#define POORT1_IS_SCHAKELEN PORTC.DIR = 0xFF
-#define POORT2_IS_SCHAKELEN PORTB.DIR = 0xFF
+struct poort1 {
+  static constexpr uint8_t nr       = 1;
+  static constexpr uint8_t dipPin   = DIP_SWITCH_2;
+  static constexpr uint8_t firstPin = PIN_PC0;
+  static constexpr uint8_t rsOffset = 1;
+  static VPORT_t &vport() {return VPORTC;}
+};
 
+struct poort2 {
+  static constexpr uint8_t nr       = 2;
+  static constexpr uint8_t dipPin   = DIP_SWITCH_3;
+  static constexpr uint8_t firstPin = PIN_PB0;
+  static constexpr uint8_t rsOffset = 2;
+  static VPORT_t &vport() {return VPORTB;}
+};
 
-// Map the 24 pins of the 25 pin SUBD connector to the AVR output pins
+
+// Map the 24 pins of the 25 pin SUBD connector (IO pin 1..24) to the AVR output pins
 // Note that we could have made a more iniuitive mapping, 
 // but that would have made PCB design more difficult
-#define POORT0_1  PIN_PD7
-#define POORT0_2  PIN_PD6
-#define POORT0_3  PIN_PD5
-#define POORT0_4  PIN_PD4
-#define POORT0_5  PIN_PD3
-#define POORT0_6  PIN_PD2
-#define POORT0_7  PIN_PD1
-#define POORT0_8  PIN_PD0
-#define POORT1_1  PIN_PC7
-#define POORT1_2  PIN_PC6
-#define POORT1_3  PIN_PC5
-#define POORT1_4  PIN_PC4
-#define POORT1_5  PIN_PC3
-#define POORT1_6  PIN_PC2
-#define POORT1_7  PIN_PC1
-#define POORT1_8  PIN_PC0
-#define POORT2_1  PIN_PB7
-#define POORT2_2  PIN_PB6
-#define POORT2_3  PIN_PB5
-#define POORT2_4  PIN_PB4
-#define POORT2_5  PIN_PB3
-#define POORT2_6  PIN_PB2
-#define POORT2_7  PIN_PB1
-#define POORT2_8  PIN_PB0
+// For each IO pin we store the POORT (0..2) and the bit within the associated AVR port.
+struct ioPinMap_t {
+  uint8_t poort;                     // 0 = PORTD, 1 = PORTC, 2 = PORTB
+  uint8_t bitMask;                   // the bit within that AVR port
+};
+
+constexpr ioPinMap_t ioPinMap[24] = {
+  {0, 0x80}, {0, 0x40}, {0, 0x20}, {0, 0x10},   // POORT0_1..4: PIN_PD7..PIN_PD4
+  {0, 0x08}, {0, 0x04}, {0, 0x02}, {0, 0x01},   // POORT0_5..8: PIN_PD3..PIN_PD0
+  {1, 0x80}, {1, 0x40}, {1, 0x20}, {1, 0x10},   // POORT1_1..4: PIN_PC7..PIN_PC4
+  {1, 0x08}, {1, 0x04}, {1, 0x02}, {1, 0x01},   // POORT1_5..8: PIN_PC3..PIN_PC0
+  {2, 0x80}, {2, 0x40}, {2, 0x20}, {2, 0x10},   // POORT2_1..4: PIN_PB7..PIN_PB4
+  {2, 0x08}, {2, 0x04}, {2, 0x02}, {2, 0x01}    // POORT2_5..8: PIN_PB3..PIN_PB0
+};
+
+// The first IO pin of a POORT is bit 7 of its AVR port. Reversing the bit order of a port value
+// gives the order of the IO pins: bit 0 is the first IO pin, as in RS-Bus nibbles and signal aspects
+inline uint8_t reverseBits(uint8_t value) {
+  value = (value & 0xF0) >> 4 | (value & 0x0F) << 4;
+  value = (value & 0xCC) >> 2 | (value & 0x33) << 2;
+  value = (value & 0xAA) >> 1 | (value & 0x55) << 1;
+  return value;
+}
+
+// The AVR port that belongs to each POORT. Via the OUTSET and OUTCLR registers of these ports,
+// individual pins can be changed with a single (and therefore atomic) write.
+extern PORT_t * const poortRegisters[3];
 
 
 class ledClass {
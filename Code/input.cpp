@@ -2,6 +2,14 @@
 // File:      input.cpp
 // Author:    Aiko Pras
 // History:   2024/05/05 AP Version 1.0
+//            2026/10/17 agent Version 1.1: the 8 pins of a port are debounced in parallel (vertical counters)
+//            2026/10/17 agent Version 1.2: settled: no pin of the port is being debounced
+//            2026/10/17 agent Version 1.3: changed: the result bits that still need to be reported
+//            2026/10/17 agent Version 1.4: inputs and outputs on one POORT (Dir_Override, Dir_Mask)
+//            2026/10/17 agent Version 1.5: restore(), and stable: the result may be reported
+//            2026/10/17 agent Version 1.6: windows are converted into samples of the adaptive rate (up to 16 bits)
+//            2026/10/17 agent Version 1.7: debounce profiles per pin and adaptive glitch filtering
+//            2026/10/17 agent Version 1.8: diagnostic counters per pin
 // 
 // Purpose:   Handling the feedback signals
 // 
@@ -10,57 +18,199 @@
 #include <AP_DCC_Decoder_Core.h>      // To include all objects, such as dcc, accCmd, etc.
 #include "hardware.h"                 // Pin assignments and #defines
 #include "dipSwitches.h"              // The three switches that determine MELDEN or SCHAKELEN
+#include "extraCVs.h"                 // Numbers of the CVs not defined by AP_DCC_Decoder_Core
+#include "sampler.h"                  // To convert the CVs into a number of samples
 #include "input.h"
 
 portClass port[3];
 
 
-void portClass::init() {
+// *******************************************************************************************************
+// Helper functions for the vertical counters
+static uint8_t bitLength(uint16_t value) {
+  // Returns the number of bitplanes that is needed to store value
+  uint8_t planes = 0;
+  while (value) {planes++; value >>= 1;}
+  return planes;
+}
+
+
+static uint8_t countDown(uint8_t *plane, const uint8_t *reload, uint8_t planes, uint8_t load) {
+  // For all 8 pins in parallel: if the bit in load is set, the counter is reloaded. 
+  // Otherwise the counter is decremented, unless it is already zero.
+  // Returns a bitmask with a 1 for each pin whose counter is (now) zero.
+  uint8_t borrow = 0;
+  for (uint8_t b = 0; b < planes; b++) {borrow |= plane[b];}
+  borrow &= ~load;                    // the (non-zero) counters that should be decremented
+  uint8_t nonZero = 0;
+  for (uint8_t b = 0; b < planes; b++) {
+    uint8_t old = plane[b];
+    // Subtracting 1 flips all bits up to and including the lowest 1 
+    plane[b] = ((old ^ borrow) & ~load) | (reload[b] & load);
+    borrow &= ~old;
+    nonZero |= plane[b];
+  }
+  return ~nonZero;
+}
+
+
+static void setPin(uint8_t *plane, uint8_t mask, uint16_t value) {
+  // Stores value as the reload value for the pin(s) in mask
+  for (uint8_t b = 0; b < 16; b++) {
+    if (bitRead(value, b)) plane[b] |= mask;
+      else plane[b] &= ~mask;
+  }
+}
+
+
+// *******************************************************************************************************
+void portClass::init(uint8_t nr) {
   // STEP 1: Read the minimum number of positive samples that need to be the same, before the signal
-  // is considered to be stable. Ensure validity and use this number to calculate a mask
+  // is considered to be stable. Ensure validity
   uint8_t minSamples  = cvValues.read(Min_1Samples);
   if (minSamples == 0) {minSamples = 1;}
   if (minSamples > 8 ) {minSamples = 8;}  
-  MinSamplesMask = 1;
-  for (uint8_t i = 1; i < minSamples; i++) {MinSamplesMask = MinSamplesMask * 2 + 1;}
   // STEP 2: Read the CV for delayOff 
-  maxDelayBeforeOff = cvValues.read(Min_0Samples);
-  // STEP 3: Initialise for each of the three ports the associated 8 pins
-  for (uint8_t i = 0; i < 3; i++) {
-    for (uint8_t j = 0; j < 8; j++) {
-      port[i].pin[j].pinHistory = 0;
-      port[i].pin[j].delayBeforeOff = 0;
-      port[i].pin[j].result = 0;
+  uint8_t maxDelayBeforeOff = cvValues.read(Min_0Samples);
+  // STEP 3: Determine for each pin its profile. Without profile, CV33 and CV34 are used.
+  // Convert the values into samples and store them as bitplanes
+  glitchShift = cvValues.read(Glitch_Filter);
+  if (glitchShift > 4) glitchShift = 0;
+  glitchThreshold = cvValues.read(Glitch_Threshold);
+  if (glitchThreshold == 0) glitchThreshold = 1;
+  uint16_t maxRise = 0;
+  uint16_t maxFall = 0;
+  for (uint8_t j = 0; j < 8; j++) {
+    uint8_t rise = minSamples;
+    uint8_t fall = maxDelayBeforeOff;
+    uint8_t profile = cvValues.read(Pin_Profile + nr * 8 + 7 - j);    // bit 7 is the first IO pin
+    if ((profile >= 1) && (profile <= PROFILES)) {
+      rise = cvValues.read(Profile_Table + 2 * (profile - 1));
+      fall = cvValues.read(Profile_Table + 2 * (profile - 1) + 1);
+      if (rise == 0) rise = 1;
     }
+    riseBase[j] = sampler.toSamples(rise);
+    fallBase[j] = sampler.toSamples(fall);
+    riseShift[j] = 0;
+    fallShift[j] = 0;
+    riseGlitches[j] = 0;
+    fallGlitches[j] = 0;
+    setPin(riseReload, bit(j), riseBase[j]);
+    setPin(fallReload, bit(j), fallBase[j]);
+    if (riseBase[j] > maxRise) maxRise = riseBase[j];
+    if (fallBase[j] > maxFall) maxFall = fallBase[j];
   }
+  // STEP 4: The counters should be wide enough for the widest window the glitch filter may set.
+  // Initially no samples are HIGH, thus riseCount starts at the reload value, like an empty pin history
+  risePlanes = bitLength(maxRise);
+  fallPlanes = bitLength(maxFall);
+  risePlanes = (risePlanes + glitchShift > 16) ? 16 : risePlanes + glitchShift;
+  fallPlanes = (fallPlanes + glitchShift > 16) ? 16 : fallPlanes + glitchShift;
+  for (uint8_t b = 0; b < 16; b++) {
+    riseCount[b] = riseReload[b];
+    fallCount[b] = 0;
+  }
+  window = 0;
+  pending = 0;
+  result = 0;
+  changed = 0;
+  settled = false;
+  // STEP 5: Inputs that keep changing would delay the first feedback forever. Therefore the port
+  // is considered stable after CV36 (Start_Delay) samples, even if it never settled
+  stable = false;
+  startCount = sampler.toSamples(cvValues.read(Start_Delay));
 }
 
 
-void portClass::check(uint8_t i, uint8_t inRegister) {
-  // note: i = port (0..2), j = pin (0..7)
-  // STEP 1: check the value for each individual pin 
-  for (uint8_t j = 0; j <= 7; j++) {
-    // STEP 1: determine the value of the input pin
-    uint8_t pinValue = bitRead(inRegister, j);
-    // STEP 2: update the pinHistory
-    // Shift all bits to the left and add the new pin value to the right 
-    port[i].pin[j].pinHistory = (port[i].pin[j].pinHistory << 1) + pinValue;    
-    // STEP 3: update delayBeforeOff
-    if (pinValue) port[i].pin[j].delayBeforeOff = maxDelayBeforeOff;
-      else if (port[i].pin[j].delayBeforeOff > 0) port[i].pin[j].delayBeforeOff--;      
-    // STEP 4 Change the result value, if needed 
-    if (port[i].pin[j].result == 0) {
-      // Should the result value change from 0 to 1?
-      // In that case, the pinHistory should have been consistently high for multiple samples
-      // We use MinSamplesMask to isolate the number of samples that should be considered
-      // If the masked value is the same as the mask itself, all samples are 1, thus "on" is stable
-      uint8_t relevantSamples = port[i].pin[j].pinHistory & MinSamplesMask; // bitwise AND (mask)
-      if (relevantSamples == MinSamplesMask) port[i].pin[j].result = 1;
-    }
-    else {
-    // Should the result value change from 1 to 0?
-    // In that case, the delayBeforeOff time should have become 0
-    if (port[i].pin[j].delayBeforeOff == 0) port[i].pin[j].result = 0;
-    }      
+void portClass::restore(uint8_t value) {
+  // The restored pins that are HIGH start as if they had been HIGH for a while, thus a LOW
+  // sample only clears them after CV34 samples. The RS-Bus nibbles are rebuilt from result
+  result = value;
+  changed = value;
+  for (uint8_t b = 0; b < fallPlanes; b++) {fallCount[b] = fallReload[b] & value;}
+  stable = true;
+}
+
+
+void portClass::check(uint8_t inRegister, uint8_t inputs) {
+  // STEP 1: update riseCount. Each LOW sample restarts the count for that pin; each HIGH sample
+  // decrements it. Once it reaches zero, the pin has consistently been HIGH for CV33 samples
+  uint8_t riseDone = countDown(riseCount, riseReload, risePlanes, ~inRegister);
+  // STEP 2: update fallCount (delayBeforeOff). Each HIGH sample reloads the count for that pin; 
+  // each LOW sample decrements it. Once it reaches zero, the pin has been LOW for CV34 samples
+  uint8_t fallDone = countDown(fallCount, fallReload, fallPlanes, inRegister);
+  // STEP 3: Change the result value, if needed 
+  // Pins that are 0 become 1 if riseCount is zero; pins that are 1 become 0 if fallCount is zero
+  // Output (SCHAKELEN) pins are not debounced, their result remains 0
+  uint8_t newResult = ((~result & riseDone) | (result & ~fallDone)) & inputs;
+  uint8_t newChanges = newResult ^ result;
+  changed |= newChanges;
+  result = newResult;
+  // STEP 4: If the result equals the sample, further samples with the same value have no effect
+  uint8_t newPending = (result ^ inRegister) & inputs;
+  settled = (newPending == 0);
+  // STEP 5: A glitch is a pin that was being debounced, but returned without changing the result.
+  // The diagnostic counters are only touched for pins that have something to count
+  uint8_t edgeMask = (inRegister ^ lastSample) & inputs;
+  lastSample = inRegister;
+  if (edgeMask) countPins(edges, edgeMask);
+  if (newChanges) countPins(transitions, newChanges);
+  uint8_t glitches = pending & ~newPending & ~newChanges;
+  if (glitches) countGlitches(glitches);
+  if (glitchShift && (++window == 0)) adaptWindows();
+  pending = newPending;
+  // STEP 6: The first time the port settles, its result may be reported
+  if (!stable) {
+    if (settled || (startCount == 0)) stable = true;
+      else startCount--;
+  }
+}
+
+
+void portClass::countPins(uint16_t *counter, uint8_t mask) {
+  for (uint8_t j = 0; j < 8; j++) {
+    if (bitRead(mask, j) && (counter[j] < 0xFFFF)) counter[j]++;
+  }
+}
+
+
+void portClass::countGlitches(uint8_t glitches) {
+  // A glitch on a pin with result 0 was a short HIGH pulse, which the rise window filtered (spike).
+  // A glitch on a pin with result 1 was a short LOW pulse, which the fall window absorbed (hold-off)
+  countPins(spikes, glitches & ~result);
+  countPins(holdOffs, glitches & result);
+  if (!glitchShift) return;
+  for (uint8_t j = 0; j < 8; j++) {
+    if (!bitRead(glitches, j)) continue;
+    if (bitRead(result, j)) {if (fallGlitches[j] < 255) fallGlitches[j]++;}
+      else {if (riseGlitches[j] < 255) riseGlitches[j]++;}
+  }
+}
+
+
+void portClass::resetDiagnostics() {
+  for (uint8_t j = 0; j < 8; j++) {
+    edges[j] = 0;
+    spikes[j] = 0;
+    holdOffs[j] = 0;
+    transitions[j] = 0;
+  }
+}
+
+
+void portClass::adaptWindows() {
+  // Called once every 256 samples. Pins with at least CV51 glitches in that period get a window 
+  // twice as wide, up to 2^CV50 times the profile value. Pins without glitches go back a step
+  for (uint8_t j = 0; j < 8; j++) {
+    if ((riseGlitches[j] >= glitchThreshold) && (riseShift[j] < glitchShift)) riseShift[j]++;
+      else if ((riseGlitches[j] == 0) && (riseShift[j] > 0)) riseShift[j]--;
+    if ((fallGlitches[j] >= glitchThreshold) && (fallShift[j] < glitchShift)) fallShift[j]++;
+      else if ((fallGlitches[j] == 0) && (fallShift[j] > 0)) fallShift[j]--;
+    uint32_t rise = (uint32_t)riseBase[j] << riseShift[j];
+    uint32_t fall = (uint32_t)fallBase[j] << fallShift[j];
+    setPin(riseReload, bit(j), (rise > 0xFFFF) ? 0xFFFF : rise);
+    setPin(fallReload, bit(j), (fall > 0xFFFF) ? 0xFFFF : fall);
+    riseGlitches[j] = 0;
+    fallGlitches[j] = 0;
   }
 }
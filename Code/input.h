@@ -2,6 +2,14 @@
 // File:      input.h
 // Author:    Aiko Pras
 // History:   2024/05/05 AP Version 1.0
+//            2026/10/17 agent Version 1.1: the 8 pins of a port are debounced in parallel (vertical counters)
+//            2026/10/17 agent Version 1.2: settled: no pin of the port is being debounced
+//            2026/10/17 agent Version 1.3: changed: the result bits that still need to be reported
+//            2026/10/17 agent Version 1.4: inputs and outputs on one POORT (Dir_Override, Dir_Mask)
+//            2026/10/17 agent Version 1.5: restore(), and stable: the result may be reported
+//            2026/10/17 agent Version 1.6: windows are converted into samples of the adaptive rate (up to 16 bits)
+//            2026/10/17 agent Version 1.7: debounce profiles per pin and adaptive glitch filtering
+//            2026/10/17 agent Version 1.8: diagnostic counters per pin
 // 
 // Purpose:   Read the values of all input pins
 // , 
@@ -16,6 +24,16 @@
 //   Only if the pin value remains LOW for a longer period, we change the result value to LOW.
 //   CV34 (Min_0Samples) determines how many samples we will wait before we change the result to LOW.
 // The main sketch determines the time between consequtive samples. A reasonable value is 10 ms.
+// If the sampler uses an adaptive rate, CV33 and CV34 are converted into the number of fast samples
+// that gives the same time, which may need up to 16 bits per counter.
+//
+// Reed contacts, current detectors and light barriers need different filtering. Therefore each pin 
+// may select one of four profiles (CV160..CV191), with its own rise and fall window. Pins without a
+// profile use CV33 and CV34.
+// If CV50 (Glitch_Filter) is set, the windows also adapt to the quality of the input: a pin that 
+// often returns to its result value before the window has passed (a glitch) gets a wider window, 
+// and a pin without glitches gets back to its profile value. Clean inputs thus keep a short latency, 
+// while dirty track does not give false occupancy.
 //
 // *******************************************************************************************************
 #pragma once
@@ -26,18 +44,49 @@
 
 class portClass {
   public: 
-    void init();
-    void check(uint8_t i, uint8_t inRegister);
+    void init(uint8_t nr);            // nr = the POORT (0..2), to find the profiles of its pins
+    void check(uint8_t inRegister, uint8_t inputs);   // inputs: the pins that are MELDEN
+    void restore(uint8_t value);      // Start with a previously stored result (see persist.h)
+
+    uint8_t result;                   // if the pin is reliably HIGH or LOW. Bit j = pin j of the AVR port
+    uint8_t changed;                  // result bits that changed since RSBusClass::check read them
+    boolean settled;                  // the last sample equals result: no pin is being debounced
+    boolean stable;                   // result may be reported: settled once, or restored, or timeout
 
-    struct {
-      uint8_t pinHistory;             // store 8 consequtive samples, to later filter spikes
-      uint8_t delayBeforeOff;         // number of sample before the result value becomes 0
-      boolean result;                 // if the pin is reliably HIGH or LOW
-    } pin[8];                         // we have 8 input pins.
+    // Diagnostics, to find bad rail joints remotely via PoM (see virtualCVs.h). Per pin (index j = 
+    // pin j of the AVR port) saturating counters since startup or the last resetDiagnostics()
+    void resetDiagnostics();
+    uint16_t edges[8];                // Samples that differ from the previous sample
+    uint16_t spikes[8];               // Short HIGH pulses that were filtered by the rise window
+    uint16_t holdOffs[8];             // Short LOW pulses that were absorbed by the fall window
+    uint16_t transitions[8];          // Changes of the debounced result
     
   private:
-    uint8_t MinSamplesMask;           // Mask which we create in init() from CV33 (Min_1Samples)
-    uint8_t maxDelayBeforeOff;        // Initialised from CV34. Number of samples 
+    // The 8 pins are debounced in parallel, using "vertical counters": bit j of riseCount[b] is bit b 
+    // of the counter for pin j. In this way all 8 counters are updated with a few byte-wide operations.
+    uint8_t riseCount[16];            // samples before the result may become 1. Reloaded from CV33 on a 0
+    uint8_t fallCount[16];            // samples before the result becomes 0. Reloaded from CV34 on a 1
+    uint8_t riseReload[16];           // Bitplanes of the value that is loaded into riseCount
+    uint8_t fallReload[16];           // Bitplanes of the value that is loaded into fallCount
+    uint8_t risePlanes;               // Number of bitplanes needed for CV33 (Min_1Samples)
+    uint8_t fallPlanes;               // Number of bitplanes needed for CV34 (Min_0Samples)
+    uint16_t startCount;              // Samples till the port is considered stable anyway (CV36)
+
+    // Glitch counting, and adaptive glitch filtering (CV50 and CV51)
+    void countGlitches(uint8_t glitches);
+    void countPins(uint16_t *counter, uint8_t mask);
+    void adaptWindows();
+    uint16_t riseBase[8];             // Per pin: the rise window of its profile, in samples
+    uint16_t fallBase[8];             // Per pin: the fall window of its profile, in samples
+    uint8_t riseShift[8];             // Per pin: the rise window is riseBase * 2^riseShift
+    uint8_t fallShift[8];             // Per pin: the fall window is fallBase * 2^fallShift
+    uint8_t riseGlitches[8];          // Per pin: short HIGH pulses in the current period
+    uint8_t fallGlitches[8];          // Per pin: short LOW pulses in the current period
+    uint8_t pending;                  // Pins whose last sample differed from the result
+    uint8_t lastSample;               // The previous sample, to count edges
+    uint8_t window;                   // Counts the samples of the current period
+    uint8_t glitchShift;              // CV50: maximum shift. 0 = no adaptive filtering
+    uint8_t glitchThreshold;          // CV51: glitches per period before the window widens
 };
 
 extern portClass port[3];             // we have three ports (0, 1 & 2)
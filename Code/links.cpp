@@ -0,0 +1,87 @@
+// *******************************************************************************************************
+// File:      links.cpp
+// Author:    agent
+// History:   2026/10/17 agent Version 1.0
+// 
+// Purpose:   Local links from an input pin to an output pin on the same decoder
+// 
+// *******************************************************************************************************
+#include <Arduino.h>                  // For general definitions
+#include <AP_DCC_Decoder_Core.h>      // To include all objects, such as dcc, accCmd, etc.
+#include "hardware.h"                 // Pin assignments and #defines
+#include "input.h"                    // The debounced input results
+#include "dccIn.h"                    // To write the outputs
+#include "links.h"
+
+linkClass links;
+
+
+void linkClass::init() {
+  for (uint8_t n = 0; n < LINKS; n++) {
+    uint8_t input = cvValues.read(Link_Table + 3 * n);
+    uint8_t output = cvValues.read(Link_Table + 3 * n + 1);
+    uint8_t delay = cvValues.read(Link_Table + 3 * n + 2);
+    uint8_t outputPin = output & 0x7F;
+    boolean used = (input >= 1) && (input <= 24) && (outputPin >= 1) && (outputPin <= 24);
+    inPin[n] = used ? input : 0;
+    outPin[n] = outputPin;
+    invert[n] = (output & 0x80);
+    delay10ms[n] = (delay == 255) ? 0 : delay;
+  }
+}
+
+
+void linkClass::write(uint8_t link, uint8_t level) {
+  // Outputs are written in the same way as routes: the pin must be an output (SCHAKELEN),
+  // running pulses are cancelled and the accessory shadow cache is updated
+  const ioPinMap_t &map = ioPinMap[outPin[link] - 1];
+  if (level) dcc_in.writePoort(map.poort, map.bitMask, 0);
+    else dcc_in.writePoort(map.poort, 0, map.bitMask);
+}
+
+
+void linkClass::start() {
+  // Bring every output in line with the current (possibly restored) input results, without delay.
+  // Thereafter only changes of the inputs are evaluated
+  for (uint8_t p = 0; p < 3; p++) {lastResult[p] = port[p].result;}
+  for (uint8_t n = 0; n < LINKS; n++) {
+    if (!inPin[n]) continue;
+    const ioPinMap_t &map = ioPinMap[inPin[n] - 1];
+    write(n, ((port[map.poort].result & map.bitMask) != 0) ^ invert[n]);
+  }
+}
+
+
+void linkClass::check() {
+  // STEP 1: Did any input result change since the previous call?
+  uint8_t changes = 0;
+  for (uint8_t p = 0; p < 3; p++) {changes |= port[p].result ^ lastResult[p];}
+  if (!changes) return;
+  // STEP 2: Evaluate the links whose input changed
+  for (uint8_t n = 0; n < LINKS; n++) {
+    if (!inPin[n]) continue;
+    const ioPinMap_t &map = ioPinMap[inPin[n] - 1];
+    uint8_t result = port[map.poort].result;
+    if (!((result ^ lastResult[map.poort]) & map.bitMask)) continue;
+    uint8_t level = ((result & map.bitMask) != 0) ^ invert[n];
+    if (delay10ms[n]) {
+      bitWrite(pending, n, 1);
+      bitWrite(pendingLevel, n, level);
+      pendingSince[n] = millis();
+    }
+    else write(n, level);
+  }
+  for (uint8_t p = 0; p < 3; p++) {lastResult[p] = port[p].result;}
+}
+
+
+void linkClass::update() {
+  if (!pending) return;
+  unsigned long now = millis();
+  for (uint8_t n = 0; n < LINKS; n++) {
+    if (bitRead(pending, n) && (now - pendingSince[n] >= delay10ms[n] * 10UL)) {
+      bitWrite(pending, n, 0);
+      write(n, bitRead(pendingLevel, n));
+    }
+  }
+}
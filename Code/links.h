@@ -0,0 +1,45 @@
+// *******************************************************************************************************
+// File:      links.h
+// Author:    agent
+// History:   2026/10/17 agent Version 1.0
+// 
+// Purpose:   Local links from an input pin to an output pin on the same decoder
+//
+// Normally an occupancy change travels via the RS-Bus to the command station and the PC, and comes
+// back as a DCC accessory command. That round trip takes hundreds of milliseconds. A link lets the 
+// debounced result of an input pin directly drive an output pin, for example to let a block signal
+// drop as soon as the block becomes occupied. The RS-Bus feedback is sent as usual.
+//
+// Links are configured via CV136..CV159 (Link_Table), see extraCVs.h. A link without delay is 
+// evaluated directly after the sample in which the input result changed. A link with delay writes the
+// output after the delay, unless the input changed again before that moment.
+//
+// *******************************************************************************************************
+#pragma once
+#include <Arduino.h>
+#include "extraCVs.h"                  // Numbers of the CVs not defined by AP_DCC_Decoder_Core
+
+
+class linkClass {
+  public:
+    void init();                         // Reads the Link_Table CVs
+    void start();                        // Applies all links once. Call after persist.init()
+    void check();                        // Called after each sample has been processed by portClass
+    void update();                       // Called from loop(): writes outputs whose delay has passed
+
+  private:
+    void write(uint8_t link, uint8_t level);
+    uint8_t inPin[LINKS];                // IO pin (1..24) of the input. 0 = link not used
+    uint8_t outPin[LINKS];               // IO pin (1..24) of the output
+    boolean invert[LINKS];               // Output is HIGH if the input is LOW
+    uint8_t delay10ms[LINKS];            // Delay in units of 10 ms. 0 = immediate
+    uint8_t lastResult[3];               // Per POORT: the input results the links have seen
+    uint8_t pending;                     // Bit n: link n waits for its delay to pass
+    uint8_t pendingLevel;                // Bit n: the level link n will write
+    unsigned long pendingSince[LINKS];   // millis() at which the input changed
+};
+
+
+// *******************************************************************************************************
+// Definition of the links object, which is declared in links.cpp but used elsewhere
+extern linkClass links;
@@ -0,0 +1,122 @@
+// *******************************************************************************************************
+// File:      logger.cpp
+// Author:    agent
+// History:   2026/10/17 agent Version 1.0
+// 
+// Purpose:   Non-blocking logging of events to the serial monitor
+// 
+// *******************************************************************************************************
+#include <Arduino.h>                  // For general definitions
+#include <AP_DCC_Decoder_Core.h>      // For the last DCC packet (dccMessage) and its type
+#include "hardware.h"                 // Pin assignments and #defines
+#include "logger.h"
+
+#if (LOG_LEVEL >= 1)
+
+loggerClass logger;
+
+
+void loggerClass::store(uint8_t type, const uint8_t *values, uint8_t count, uint16_t time) {
+  uint16_t thisSequence = sequence++;    // Dropped events also use a number, to show the gap
+  uint8_t next = (head + 1) & (LOG_BUFFER_SIZE - 1);
+  if (next == tail) {
+    if (overflows < 0xFFFF) overflows++;
+    return;
+  }
+  if (count > LOG_VALUES) count = LOG_VALUES;
+  events[head].type = type;
+  events[head].count = count;
+  for (uint8_t i = 0; i < count; i++) events[head].values[i] = values[i];
+  events[head].sequence = thisSequence;
+  events[head].time = time;
+  head = next;
+}
+
+
+void loggerClass::log(uint8_t type, uint8_t value1, uint8_t value2) {
+  uint8_t values[2] = {value1, value2};
+  store(type, values, 2, millis());
+}
+
+
+void loggerClass::traceSample(const uint8_t *sample, uint16_t time) {
+  for (uint8_t p = 0; p < 3; p++) {
+    if (sample[p] != lastSample[p]) {
+      uint8_t values[2] = {p, sample[p]};
+      store(LOG_TYPE_IN, values, 2, time);
+    }
+    lastSample[p] = sample[p];
+  }
+}
+
+
+void loggerClass::tracePacket() {
+  uint8_t values[LOG_VALUES];
+  values[0] = dcc.cmdType;
+  uint8_t count = 1;
+  for (uint8_t i = 0; (i < dccMessage.size) && (count < LOG_VALUES); i++) values[count++] = dccMessage.data[i];
+  store(LOG_TYPE_DCC, values, count, millis());
+}
+
+
+void loggerClass::printTrace() {
+  static const char * const keywords[] = {"?", "DIP", "ACC", "ROUTE", "EXT", "DCC", "IN", "RS"};
+  uint8_t type = events[tail].type;
+  Serial.print(events[tail].time);
+  Serial.print(" T ");
+  Serial.print(events[tail].sequence);
+  Serial.print(" ");
+  Serial.print((type <= LOG_TYPE_RS) ? keywords[type] : keywords[0]);
+  for (uint8_t i = 0; i < events[tail].count; i++) {
+    Serial.print(" ");
+    Serial.print(events[tail].values[i]);
+  }
+  Serial.println();
+}
+
+
+void loggerClass::drain() {
+  if (Serial.availableForWrite() < LOG_LINE_MAX) return;
+  if (overflows != overflowsPrinted) {
+    overflowsPrinted = overflows;
+    Serial.print("Log overflows: ");
+    Serial.println(overflows);
+    return;
+  }
+  if (tail == head) return;
+  #if (LOG_LEVEL >= 3)
+  printTrace();
+  #else
+  Serial.print(events[tail].time);
+  switch (events[tail].type) {
+    case LOG_TYPE_DIP:
+      Serial.print(" DIP switch ");
+      Serial.print(events[tail].values[0]);
+      if (events[tail].values[1] == MELDEN) Serial.println(": Melden");
+        else Serial.println(": Schakelen");
+    break;
+    case LOG_TYPE_ACC:
+      Serial.print(" I/O pin: ");
+      Serial.print(events[tail].values[0]);
+      if (events[tail].values[1] == 1) Serial.println(" +");
+        else Serial.println(" -");
+    break;
+    case LOG_TYPE_ROUTE:
+      Serial.print(" Route: ");
+      Serial.println(events[tail].values[0]);
+    break;
+    case LOG_TYPE_EXTENDED:
+      Serial.print(" POORT");
+      Serial.print(events[tail].values[0]);
+      Serial.print(" aspect: ");
+      Serial.println(events[tail].values[1]);
+    break;
+    default:
+      Serial.println(" ?");
+    break;
+  }
+  #endif
+  tail = (tail + 1) & (LOG_BUFFER_SIZE - 1);
+}
+
+#endif
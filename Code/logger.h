@@ -0,0 +1,112 @@
+// *******************************************************************************************************
+// File:      logger.h
+// Author:    agent
+// History:   2026/10/17 agent Version 1.0
+// 
+// Purpose:   Non-blocking logging of events to the serial monitor
+//
+// Serial.print() blocks once the UART transmit buffer is full. At 115200 baud a burst of accessory
+// commands could therefore stall loop() for several ms. Instead, events are stored in binary form
+// (type, two values and a timestamp) in a ring buffer. drain() prints at most one event per call,
+// and only if the UART transmit buffer has room for the complete line. If the ring buffer is full,
+// the new event is dropped and the overflow counter is incremented.
+//
+// LOG_LEVEL determines at compile time what is logged:
+// 0: nothing. The logger is not compiled in at all
+// 1: DIP switch changes
+// 2: also all accessory commands and routes this decoder reacts on
+// 3: also a trace of everything that goes in and out of the decoder: all accessory packets (basic
+//    and extended), every sample of a POORT that differs from the previous sample, and all RS-Bus 
+//    feedback values. Such a trace shows what a decoder at a customer layout has seen and reported.
+//    At this level all events, including DIP switch changes, are printed in one line format:
+//      <time> T <sequence> <keyword> <value> <value> ...
+//    The time is the moment the event was captured (for samples: the moment the ISR took the sample),
+//    in ms, lower 16 bits. Every event gets the next sequence number, also if it is dropped because
+//    the ring buffer is full. A gap in the sequence numbers thus shows which events are missing.
+//    Keywords and values:
+//      DIP <switch> <setting>          ACC <IO pin> <position>       ROUTE <route>
+//      EXT <POORT> <aspect>            IN <POORT> <IN register>      RS <POORT> <feedback value>
+//      DCC <cmdType> <byte> <byte> ... (all bytes of the packet, including the error detection byte)
+//
+// *******************************************************************************************************
+#pragma once
+#include <Arduino.h>
+
+#ifndef LOG_LEVEL                        // May also be set via the compiler flags: -DLOG_LEVEL=...
+#define LOG_LEVEL           2            // 0 = none, 1 = DIP switches, 2 = also accessory commands,
+#endif                                   // 3 = also a trace of samples, packets and feedback
+
+#define LOG_BUFFER_SIZE     32           // Must be a power of 2
+#define LOG_LINE_MAX        48           // Maximum number of characters that drain() prints per event
+#if (LOG_LEVEL >= 3)
+  #define LOG_VALUES        7            // cmdType and the (at most 6) bytes of a DCC packet
+#else
+  #define LOG_VALUES        2
+#endif
+
+#define LOG_TYPE_DIP        1            // value1 = DIP switch (1..3), value2 = MELDEN / SCHAKELEN
+#define LOG_TYPE_ACC        2            // value1 = IO pin (1..24), value2 = position
+#define LOG_TYPE_ROUTE      3            // value1 = route (1..8)
+#define LOG_TYPE_EXTENDED   4            // value1 = POORT (0..2), value2 = aspect
+#define LOG_TYPE_DCC        5            // values = cmdType, followed by all bytes of the packet
+#define LOG_TYPE_IN         6            // value1 = POORT (0..2), value2 = sample of the IN register
+#define LOG_TYPE_RS         7            // value1 = POORT (0..2), value2 = feedback value (8 bits)
+
+
+#if (LOG_LEVEL >= 1)
+  #define LOG_DRAIN()                 logger.drain()
+  #define LOG_DIP(dip, setting)       logger.log(LOG_TYPE_DIP, dip, setting)
+#else
+  #define LOG_DRAIN()
+  #define LOG_DIP(dip, setting)
+#endif
+#if (LOG_LEVEL >= 2)
+  #define LOG_ACC(pin, position)      logger.log(LOG_TYPE_ACC, pin, position)
+  #define LOG_ROUTE(route)            logger.log(LOG_TYPE_ROUTE, route, 0)
+  #define LOG_EXTENDED(poort, aspect) logger.log(LOG_TYPE_EXTENDED, poort, aspect)
+#else
+  #define LOG_ACC(pin, position)
+  #define LOG_ROUTE(route)
+  #define LOG_EXTENDED(poort, aspect)
+#endif
+#if (LOG_LEVEL >= 3)
+  #define LOG_DCC()                   logger.tracePacket()
+  #define LOG_SAMPLE(sample, time)    logger.traceSample(sample, time)
+  #define LOG_RS(poort, value)        logger.log(LOG_TYPE_RS, poort, value)
+#else
+  #define LOG_DCC()
+  #define LOG_SAMPLE(sample, time)
+  #define LOG_RS(poort, value)
+#endif
+
+
+class loggerClass {
+  public:
+    void log(uint8_t type, uint8_t value1, uint8_t value2);
+    void drain();                        // Should be called from loop()
+    void traceSample(const uint8_t *sample, uint16_t time);  // Logs the POORTs whose sample changed
+    void tracePacket();                  // Logs the type and all bytes of the last DCC packet
+
+    uint16_t overflows;                  // Number of events that were dropped
+
+  private:
+    void store(uint8_t type, const uint8_t *values, uint8_t count, uint16_t time);
+    void printTrace();                   // Prints the oldest entry in the trace line format
+    struct {
+      uint8_t type;
+      uint8_t count;                     // Number of values
+      uint8_t values[LOG_VALUES];
+      uint16_t sequence;
+      uint16_t time;                     // millis() at capture, lower 16 bits
+    } events[LOG_BUFFER_SIZE];
+    uint16_t sequence;                   // Sequence number of the next event
+    uint8_t head;                        // Next free entry
+    uint8_t tail;                        // Oldest entry that is not yet printed
+    uint16_t overflowsPrinted;           // To print the overflow counter only after a change
+    uint8_t lastSample[3];               // The previous sample of each POORT
+};
+
+
+// *******************************************************************************************************
+// Definition of the logger object, which is declared in logger.cpp but used elsewhere
+extern loggerClass logger;
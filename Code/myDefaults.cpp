@@ -2,12 +2,20 @@
 // File:      myDefaults.cpp
 // Author:    Aiko Pras
 // History:   2024/05/05 AP Version 1.0
+//            2026/10/17 agent Version 1.1: default of Input_Mode
+//            2026/10/17 agent Version 1.2: default of Route_Address
+//            2026/10/17 agent Version 1.3: defaults of Ext_Address and Ext_Bit_Order
+//            2026/10/17 agent Version 1.4: inputs and outputs on one POORT (Dir_Override, Dir_Mask)
+//            2026/10/17 agent Version 1.5: default of Persist_Interval
+//            2026/10/17 agent Version 1.6: default of Fast_Interval
+//            2026/10/17 agent Version 1.7: defaults of Glitch_Filter and Glitch_Threshold
 // 
 // Purpose:   To set the CV defaults
 //
 // ******************************************************************************************************
 #include <AP_DCC_Decoder_Core.h>      // To include all objects, such as dcc, accCmd, etc.
 #include "myDefaults.h"
+#include "extraCVs.h"
 
 
 void myDefaults_class::init() {
@@ -15,5 +23,20 @@ void myDefaults_class::init() {
   cvValues.defaults[myAddrH]       = MY_CV9;
   cvValues.defaults[myRSAddr]      = MY_CV10; 
   // cvValues.defaults[CmdStation] = OpenDCC;
+  cvValues.defaults[Input_Mode]    = 0;         // Fixed rate sampling
+  cvValues.defaults[Fast_Interval] = 2;         // Adaptive rate: 2 ms while debouncing
+  cvValues.defaults[Route_Address] = 0;         // No routes
+  cvValues.defaults[Route_Address + 1] = 0;
+  cvValues.defaults[Ext_Address]   = 0;         // No extended accessory packets
+  cvValues.defaults[Ext_Address + 1] = 0;
+  cvValues.defaults[Ext_Bit_Order] = 0;
+  cvValues.defaults[Dir_Override]  = 0;         // The DIP switches determine the direction
+  cvValues.defaults[Dir_Mask]      = 0;
+  cvValues.defaults[Dir_Mask + 1]  = 0;
+  cvValues.defaults[Dir_Mask + 2]  = 0;
+  cvValues.defaults[Output_Report] = 0;         // Output pins are reported as 0
+  cvValues.defaults[Persist_Interval] = 60;     // Store the input state at most once per minute
+  cvValues.defaults[Glitch_Filter] = 0;         // Fixed debounce windows
+  cvValues.defaults[Glitch_Threshold] = 2;
 
 }
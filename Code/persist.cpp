@@ -0,0 +1,73 @@
+// *******************************************************************************************************
+// File:      persist.cpp
+// Author:    agent
+// History:   2026/10/17 agent Version 1.0
+// 
+// Purpose:   Keep the last known input state in EEPROM, for immediate feedback after power-up
+// 
+// *******************************************************************************************************
+#include <Arduino.h>                  // For general definitions
+#include <EEPROM.h>                   // Access to the EEPROM bytes that are not used for CVs
+#include <AP_DCC_Decoder_Core.h>      // To include all objects, such as dcc, accCmd, etc.
+#include "extraCVs.h"                 // Numbers of the CVs not defined by AP_DCC_Decoder_Core
+#include "dipSwitches.h"              // Which pins are inputs
+#include "input.h"                    // The debounced input results
+#include "persist.h"
+
+persistClass persist;
+
+
+void persistClass::init() {
+  interval = cvValues.read(Persist_Interval);
+  if (interval == 255) interval = 0;
+  // STEP 1: Find the last record: the valid slot whose successor does not hold the next number
+  slot = PERSIST_SLOTS - 1;
+  seq = 254;                          // If no record is found, the first record will be slot 0, seq 0
+  if (!interval) return;
+  boolean found = false;
+  for (uint8_t i = 0; i < PERSIST_SLOTS; i++) {
+    uint8_t thisSeq = EEPROM.read(PERSIST_EEPROM + i * PERSIST_SLOT_SIZE);
+    uint8_t nextSeq = EEPROM.read(PERSIST_EEPROM + ((i + 1) % PERSIST_SLOTS) * PERSIST_SLOT_SIZE);
+    if ((thisSeq != 255) && (nextSeq != (thisSeq + 1) % 255)) {
+      slot = i;
+      seq = thisSeq;
+      found = true;
+      break;
+    }
+  }
+  if (!found) return;
+  // STEP 2: Restore the results of the input pins
+  for (uint8_t p = 0; p < 3; p++) {
+    saved[p] = EEPROM.read(PERSIST_EEPROM + slot * PERSIST_SLOT_SIZE + 1 + p);
+    if (dipSwitches.hasInputs(p)) port[p].restore(saved[p] & ~dipSwitches.outputs[p]);
+  }
+}
+
+
+void persistClass::update() {
+  if (!interval) return;
+  // STEP 1: Continue writing the current record, one byte at a time. The sequence number goes last
+  if (toWrite) {
+    if (NVMCTRL.STATUS & NVMCTRL_EEBUSY_bm) return;
+    toWrite--;
+    uint8_t i = (toWrite) ? PERSIST_SLOT_SIZE - toWrite : 0;
+    EEPROM.update(PERSIST_EEPROM + slot * PERSIST_SLOT_SIZE + i, record[i]);
+    return;
+  }
+  // STEP 2: Start a new record if a stable result changed, and the interval has passed
+  if ((millis() - lastWrite) < interval * 1000UL) return;
+  boolean differs = false;
+  for (uint8_t p = 0; p < 3; p++) {
+    if (port[p].stable && (port[p].result != saved[p])) differs = true;
+  }
+  if (!differs) return;
+  slot = (slot + 1) % PERSIST_SLOTS;
+  seq = (seq + 1) % 255;
+  record[0] = seq;
+  for (uint8_t p = 0; p < 3; p++) {
+    if (port[p].stable) saved[p] = port[p].result;
+    record[1 + p] = saved[p];
+  }
+  toWrite = PERSIST_SLOT_SIZE;
+  lastWrite = millis();
+}
@@ -0,0 +1,56 @@
+// *******************************************************************************************************
+// File:      persist.h
+// Author:    agent
+// History:   2026/10/17 agent Version 1.0
+// 
+// Purpose:   Keep the last known input state in EEPROM, for immediate feedback after power-up
+//
+// After a power cycle of the layout, the PC would see empty blocks until the inputs have been sampled
+// and debounced. Therefore the debounced results of the input pins are stored in EEPROM, and restored 
+// at startup. The decoder can thus answer the first RS-Bus poll right away with the last known state.
+// If the actual input differs, the normal debouncing corrects the result and feedback is sent.
+//
+// To limit EEPROM wear:
+// - a record is only written if a result changed, and at most once every CV48 (Persist_Interval)
+//   seconds. If CV48 is 0, the state is neither stored nor restored.
+// - records are written round robin into 64 slots of 4 bytes: a sequence number and the results of
+//   POORT0..2. The slot with the highest sequence number holds the last known state.
+// - writing is non-blocking: update() writes at most one byte, and only if the EEPROM is not busy.
+//   The sequence number is written last, thus an interrupted write leaves the previous record valid.
+//
+// Expected lifetime: the EEPROM endures 100,000 writes per byte. Each byte of a slot is written once
+// per 64 records. In the worst case, inputs that change all the time, a record is written every CV48
+// seconds. With the default of 60 seconds, a slot is then written every 64 minutes, and the EEPROM
+// lasts 64 * 60 * 100,000 s, thus about 12 years of continuous operation. A layout that is only 
+// powered a few hours a day, or has quiet periods, lasts correspondingly longer. CV48 = 10 would
+// give about 2 years. The price of a longer interval: a change in the last CV48 seconds before the
+// power is switched off is not restored.
+//
+// *******************************************************************************************************
+#pragma once
+#include <Arduino.h>
+
+#define PERSIST_EEPROM      256          // First EEPROM byte used. The CVs use EEPROM 0..255
+#define PERSIST_SLOTS       64           // Up to the end of the EEPROM (512 bytes). Less than 255
+#define PERSIST_SLOT_SIZE   4            // Sequence number (0..254, 255 = erased) + 3 results
+
+
+class persistClass {
+  public:
+    void init();                         // Must be called after port[].init()
+    void update();                       // Called from loop()
+
+  private:
+    uint16_t interval;                   // CV48: seconds between writes. 0 = not used
+    uint8_t slot;                        // Slot of the last record
+    uint8_t seq;                         // Sequence number of the last record
+    uint8_t saved[3];                    // The results in the last record
+    uint8_t record[PERSIST_SLOT_SIZE];   // The record that is being written
+    uint8_t toWrite;                     // Bytes of record that still need to be written
+    unsigned long lastWrite;             // millis() at which the last record was started
+};
+
+
+// *******************************************************************************************************
+// Definition of the persist object, which is declared in persist.cpp but used elsewhere
+extern persistClass persist;
@@ -0,0 +1,71 @@
+// *******************************************************************************************************
+// File:      profiler.cpp
+// Author:    agent
+// History:   2026/10/17 agent Version 1.0
+// 
+// Purpose:   Measure how long each of the steps in loop() takes
+// 
+// *******************************************************************************************************
+#include <Arduino.h>                  // For general definitions
+#include "profiler.h"
+
+#if defined(PROFILING)
+
+profilerClass profiler;
+
+
+void profilerClass::reset() {
+  for (uint8_t i = 0; i < PROFILE_STEPS; i++) {
+    steps[i].minimum = 0xFFFF;
+    steps[i].maximum = 0;
+    for (uint8_t k = 0; k < PROFILE_BUCKETS; k++) steps[i].buckets[k] = 0;
+  }
+}
+
+
+void profilerClass::start() {
+  // The first call also initialises the statistics 
+  static bool initialised = false;
+  if (!initialised) {
+    reset();
+    initialised = true;
+  }
+  startTime = micros();
+}
+
+
+void profilerClass::stop(uint8_t step) {
+  unsigned long now = micros();
+  unsigned long duration = now - startTime;
+  startTime = now;
+  uint16_t us = (duration > 0xFFFF) ? 0xFFFF : duration;
+  if (us < steps[step].minimum) steps[step].minimum = us;
+  if (us > steps[step].maximum) steps[step].maximum = us;
+  // Determine the bucket: the position of the highest bit that is set
+  uint8_t bucket = 0;
+  while ((us > 1) && (bucket < PROFILE_BUCKETS - 1)) {
+    us >>= 1;
+    bucket++;
+  }
+  if (steps[step].buckets[bucket] < 0xFFFF) steps[step].buckets[bucket]++;
+}
+
+
+void profilerClass::select(uint8_t step) {
+  if (step == 255) reset();
+    else if (step < PROFILE_STEPS) selected = step;
+}
+
+
+uint8_t profilerClass::cvValue(uint8_t offset) {
+  uint16_t value;
+  if (offset == 0) return selected;
+  if (offset <= 2) value = steps[selected].minimum;
+    else if (offset <= 4) value = steps[selected].maximum;
+    else value = steps[selected].buckets[(offset - 5) / 2];
+  // Odd offsets return the low byte, even offsets the high byte
+  if (offset & 1) return lowByte(value);
+  return highByte(value);
+}
+
+#endif
@@ -0,0 +1,60 @@
+// *******************************************************************************************************
+// File:      profiler.h
+// Author:    agent
+// History:   2026/10/17 agent Version 1.0
+//            2026/10/17 agent Version 1.1: the steps are the tasks of the scheduler, numbered by their index in tasks[]
+// 
+// Purpose:   Measure how long each of the tasks in loop() takes
+//
+// Only if PROFILING is defined, the profiler is compiled in. For normal use PROFILING should 
+// remain commented out, since the measurements itself take some time (and RAM).
+// For each of the tasks in loop() (see scheduler.h) we store the minimum and maximum duration (in us), as well as
+// a histogram with logarithmic buckets: bucket 0 counts durations < 2us, bucket 1 2..3us, 
+// bucket 2 4..7us, ..., bucket 11 2048us and longer. All counters saturate at 65535.
+// The values can be read via PoM as read-only CVs (see extraCVs.h):
+// - write the number of the task to CV200 (Prof_Select). Writing 255 resets all values.
+//   The number is the index in tasks[] of the main sketch, as for the deadline misses (CV253)
+// - read CV201..CV204 (minimum and maximum, low byte first) and CV205..CV228 (12 buckets, idem)
+//
+// *******************************************************************************************************
+#pragma once
+#include <Arduino.h>
+#include "scheduler.h"                   // For the number of tasks
+
+// #define PROFILING                     // Uncomment to measure the duration of the steps in loop()
+
+#define PROFILE_STEPS       TASKS        // One step per entry in tasks[]
+#define PROFILE_BUCKETS     12
+
+
+#if defined(PROFILING)
+  #define PROFILE_START()     profiler.start()
+  #define PROFILE_STEP(step)  profiler.stop(step)
+#else
+  #define PROFILE_START()
+  #define PROFILE_STEP(step)
+#endif
+
+
+class profilerClass {
+  public:
+    void start();                        // Called at the start of a task
+    void stop(uint8_t step);             // Called at the end of a task
+    void select(uint8_t step);           // Select the step that will be returned by cvValue()
+    uint8_t cvValue(uint8_t offset);     // offset 0 = Prof_Select
+
+  private:
+    void reset();
+    unsigned long startTime;             // micros() at the start of the current step
+    uint8_t selected;
+    struct {
+      uint16_t minimum;
+      uint16_t maximum;
+      uint16_t buckets[PROFILE_BUCKETS];
+    } steps[PROFILE_STEPS];
+};
+
+
+// *******************************************************************************************************
+// Definition of the profiler object, which is declared in profiler.cpp but used elsewhere
+extern profilerClass profiler;
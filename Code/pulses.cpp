@@ -0,0 +1,74 @@
+// *******************************************************************************************************
+// File:      pulses.cpp
+// Author:    agent
+// History:   2026/10/17 agent Version 1.0
+// 
+// Purpose:   Pulsed outputs, for example to drive solenoids of turnouts or relays
+// 
+// *******************************************************************************************************
+#include <Arduino.h>                  // For general definitions
+#include <AP_DCC_Decoder_Core.h>      // To include all objects, such as dcc, accCmd, etc.
+#include "hardware.h"                 // Pin assignments and #defines
+#include "extraCVs.h"                 // Numbers of the CVs not defined by AP_DCC_Decoder_Core
+#include "pulses.h"
+
+pulseClass pulses;
+
+
+void pulseClass::init() {
+  for (uint8_t i = 0; i < 24; i++) {
+    uint8_t value = cvValues.read(Pulse_Time + i);
+    durations[i] = (value == 255) ? 0 : value;
+  }
+}
+
+
+uint8_t pulseClass::duration(uint8_t ioPin) {
+  return durations[ioPin - 1];
+}
+
+
+void pulseClass::start(uint8_t ioPin) {
+  const ioPinMap_t &map = ioPinMap[ioPin - 1];
+  uint8_t oldSREG = SREG;
+  cli();
+  if (running[map.poort] & map.bitMask) wheel[slotOf[ioPin - 1]][map.poort] &= ~map.bitMask;
+  uint8_t slot = now + durations[ioPin - 1] + 1;    // +1: the current slot is partly over. Wraps at 256
+  slotOf[ioPin - 1] = slot;
+  wheel[slot][map.poort] |= map.bitMask;
+  running[map.poort] |= map.bitMask;
+  SREG = oldSREG;
+}
+
+
+void pulseClass::cancel(uint8_t ioPin) {
+  const ioPinMap_t &map = ioPinMap[ioPin - 1];
+  uint8_t oldSREG = SREG;
+  cli();
+  if (running[map.poort] & map.bitMask) {
+    wheel[slotOf[ioPin - 1]][map.poort] &= ~map.bitMask;
+    running[map.poort] &= ~map.bitMask;
+  }
+  SREG = oldSREG;
+}
+
+
+bool pulseClass::active(uint8_t ioPin) {
+  const ioPinMap_t &map = ioPinMap[ioPin - 1];
+  return (running[map.poort] & map.bitMask);
+}
+
+
+void pulseClass::tick() {
+  if (++divider < PULSE_TICK) return;
+  divider = 0;
+  now++;
+  for (uint8_t p = 0; p < 3; p++) {
+    uint8_t expired = wheel[now][p];
+    if (expired) {
+      poortRegisters[p]->OUTCLR = expired;
+      running[p] &= ~expired;
+      wheel[now][p] = 0;
+    }
+  }
+}
@@ -0,0 +1,51 @@
+// *******************************************************************************************************
+// File:      pulses.h
+// Author:    agent
+// History:   2026/10/17 agent Version 1.0
+// 
+// Purpose:   Pulsed outputs, for example to drive solenoids of turnouts or relays
+//
+// For each IO pin a pulse duration can be set via CV64..CV87 (Pulse_Time), in units of 10 ms.
+// After such output is made HIGH, it is made LOW again by the 1 ms timer interrupt (see sampler.cpp),
+// thus independent of how long loop() takes and without a second DCC "off" command.
+// 
+// The deadlines are stored in a timing wheel: an array of 256 slots of 10 ms each, one slot for 
+// every possible deadline. Each slot contains for each POORT a bitmask with the outputs that should 
+// be made LOW at that moment. Every 10 ms the ISR moves to the next slot and clears the outputs in 
+// that slot with at most three OUTCLR writes. Starting or cancelling a pulse sets or clears a single
+// bit. Thus all operations take constant time, regardless of how many of the 24 outputs are pulsing.
+// A pulse may start anywhere within the current 10 ms slot. Therefore a pulse of d ticks ends d + 1 
+// slots later: its length is at least d * 10 ms and at most (d + 1) * 10 ms. This guarantees the 
+// minimum length that coils need, also for d = 1.
+// Since pulse durations are at most 254 ticks, a slot (now + 255 at most) is never reused before 
+// it has expired.
+//
+// *******************************************************************************************************
+#pragma once
+#include <Arduino.h>
+
+#define PULSE_TICK          10           // ms per slot of the timing wheel
+
+
+class pulseClass {
+  public:
+    void init();                         // Reads the Pulse_Time CVs
+    uint8_t duration(uint8_t ioPin);     // ioPin = 1..24. Returns 0 if the output is not pulsed 
+    void start(uint8_t ioPin);           // Schedule the end of the pulse. The caller sets the pin HIGH
+    void cancel(uint8_t ioPin);          // Remove the pin from the timing wheel
+    bool active(uint8_t ioPin);          // Is the pulse still running?
+    void tick();                         // Called every ms by the timer ISR
+
+  private:
+    uint8_t durations[24];               // Copy of the Pulse_Time CVs (0 = not pulsed)
+    uint8_t slotOf[24];                  // The slot in which each running pulse ends
+    volatile uint8_t wheel[256][3];      // Per slot and per POORT: the outputs to be made LOW
+    volatile uint8_t running[3];         // Per POORT: the outputs with a running pulse
+    volatile uint8_t now;                // The current slot
+    uint8_t divider;                     // Counts ms till the next slot
+};
+
+
+// *******************************************************************************************************
+// Definition of the pulses object, which is declared in pulses.cpp but used elsewhere
+extern pulseClass pulses;
@@ -2,6 +2,13 @@
 // File:      RSBus.cpp
 // Author:    Aiko Pras
 // History:   2024/05/09 AP Version 1.0
+//            2026/10/17 agent Version 1.1: the nibbles are taken from the result byte of the port
+//            2026/10/17 agent Version 1.2: changes are combined per connection, at most once per RS_SEND_INTERVAL
+//            2026/10/17 agent Version 1.3: RSBusClass is a template on the POORT descriptor
+//            2026/10/17 agent Version 1.4: uses reverseBits() of hardware.h
+//            2026/10/17 agent Version 1.5: inputs and outputs on one POORT (Dir_Override, Dir_Mask)
+//            2026/10/17 agent Version 1.6: LOG_LEVEL 3 traces the feedback values (logger.h)
+//            2026/10/17 agent Version 1.7: new input changes are sent before resyncs; a resync waits at most RS_RESYNC_MAX_AGE ms
 // 
 // Purpose:   Sending RS-Bus feedback messages
 //            Reads the pin values and sends a feedback message once a pin value changed.
@@ -12,11 +19,15 @@
 #include "myDefaults.h"               // Default values for this specific board
 #include "dipSwitches.h"              // The three switches that determine MELDEN or SCHAKELEN
 #include "input.h"                    // To handle all IO input pins
+#include "extraCVs.h"                 // Numbers of the CVs not defined by AP_DCC_Decoder_Core
+#include "logger.h"                   // To trace the feedback values
 #include "rsBus.h"
 
 
 CommonRSBusClass RSCommon;            // Object to initialises the RS-Bus addresses
-RSBusClass feedback[3];               // Object for the three RS-Bus connections 
+RSBusClass<poort0> feedback0;         // Objects for the three RS-Bus connections 
+RSBusClass<poort1> feedback1;
+RSBusClass<poort2> feedback2;
 DccTimer RSLedTimer;                  // To switch the LED off that signals the transmission of a feedback message
 
 extern RSbusHardware rsbusHardware;  // This object is defined in rs_bus.cpp
@@ -26,10 +37,18 @@ extern RSbusHardware rsbusHardware;  // This object is defined in rs_bus.cpp
 void CommonRSBusClass::init() {
   uint8_t firstRSAddress = cvValues.read(myRSAddr);      // 1.. 127
   if (firstRSAddress <= 125) {
-    feedback[0].rsbus.address = firstRSAddress;
-    feedback[1].rsbus.address = firstRSAddress + 1;
-    feedback[2].rsbus.address = firstRSAddress + 2;
+    feedback0.rsbus.address = firstRSAddress + poort0::rsOffset;
+    feedback1.rsbus.address = firstRSAddress + poort1::rsOffset;
+    feedback2.rsbus.address = firstRSAddress + poort2::rsOffset;
   }
+  echoOutputs = (cvValues.read(Output_Report) == 1);
+}
+
+
+void CommonRSBusClass::showTransmission() {
+  // Turn the FB LED on; maintain() turns it off after 1 second
+  digitalWriteFast(LED_FB, HIGH);
+  RSLedTimer.setTime(1000); 
 }
 
 
@@ -40,53 +59,80 @@ void CommonRSBusClass::checkLed() {
 
 
 // *******************************************************************************************************
-void RSBusClass::check(uint8_t i) {
-  // i is the input port (0..2) 
-  boolean sendLowNibble = false;
-  boolean sendHighNibble = false;
+template <class POORT> void RSBusClass<POORT>::sendChanges() {
+  portClass &input = port[POORT::nr];  // the debounced input values of this POORT
   //  
-  // STEP 1: read the 8 pin values of this port, and update (if needed)
-  // the lowNibble and highNibble variable. Set a flag if such variable changes
-  uint8_t newNibble = 0;
-  // Low nibble first
-  for (uint8_t j = 4; j < 8; j++) {
-    newNibble = (newNibble << 1);    // Shift 1 bit to the left
-    newNibble = newNibble | port[i].pin[j].result;
-  }
-  if (newNibble != lowNibble) {
-    lowNibble = newNibble;
-    sendLowNibble = true;
-  }
-  // High nibble after
-  newNibble = 0;
-  for (uint8_t j = 0; j < 4; j++) {
-    newNibble = (newNibble << 1);    // Shift 1 bit to the left
-    newNibble = newNibble | port[i].pin[j].result;
-  }
-  if (newNibble != highNibble) {
-    highNibble = newNibble;
-    sendHighNibble = true;
+  // STEP 1: if one or more pin values of this port changed, update the lowNibble and highNibble.
+  // Output pins are reported as 0, or with their actual level if CV47 (Output_Report) says so.
+  // Pin 0 of the AVR port becomes the most significant bit of the highNibble, and
+  // pin 7 the least significant bit of the lowNibble. Therefore we first reverse the bit order
+  uint8_t outputs = dipSwitches.outputs[POORT::nr];
+  uint8_t newEcho = (RSCommon.echoOutputs) ? (POORT::vport().OUT & outputs) : 0;
+  if (input.changed || (newEcho != echo)) {
+    input.changed = 0;
+    echo = newEcho;
+    uint8_t reversed = reverseBits((input.result & ~outputs) | echo);
+    lowNibble = reversed & 0x0F;
+    highNibble = reversed >> 4;
   }
-  // STEP 2: if a change was detected, send the new nibble value
-  if (sendLowNibble)  rsbus.send4bits(LowBits,  lowNibble);
-  if (sendHighNibble) rsbus.send4bits(HighBits, highNibble);
-  //
-  // STEP 3: Check if we have to (re)establish a RS-Bus connection.
+  // STEP 2: While a resync is requested, the resync will carry the latest nibbles
+  if (rsbus.feedbackRequested) return;
+  // STEP 3: if a nibble differs from what was sent last, and the previous message for this connection
+  // was handed over long enough ago, send the new nibble value(s)
+  boolean sendLowNibble = (lowNibble != sentLowNibble);
+  boolean sendHighNibble = (highNibble != sentHighNibble);
+  if (!(sendLowNibble || sendHighNibble)) return;
+  RSCommon.lastChange[POORT::nr] = millis();   // Resyncs of other connections should wait
+  if ((millis() - lastSendTime) < RS_SEND_INTERVAL) return;
+  if (sendLowNibble && sendHighNibble) rsbus.send8bits(highNibble << 4 | lowNibble);
+    else if (sendLowNibble) rsbus.send4bits(LowBits, lowNibble);
+    else rsbus.send4bits(HighBits, highNibble);
+  sentLowNibble = lowNibble;
+  sentHighNibble = highNibble;
+  lastSendTime = millis();
+  LOG_RS(POORT::nr, highNibble << 4 | lowNibble);
+  RSCommon.showTransmission();
+}
+
+
+template <class POORT> void RSBusClass<POORT>::maintain() {
+  // STEP 1: Check if we have to (re)establish a RS-Bus connection.
   // This is the case after a decoder (re)start or after a RS-Bus error. 
-  uint8_t startValue = (highNibble << 4 | lowNibble);
-  if (rsbus.feedbackRequested) rsbus.send8bits(startValue);
+  // The start value contains the latest nibbles, thus nothing remains to be sent thereafter.
+  // The resync waits while other connections have changes, but at most RS_RESYNC_MAX_AGE ms
+  if (rsbus.feedbackRequested) {
+    if (!resyncWaiting) {
+      resyncWaiting = true;
+      resyncSince = millis();
+    }
+    boolean othersBusy = false;
+    for (uint8_t p = 0; p < 3; p++) {
+      if ((p != POORT::nr) && ((millis() - RSCommon.lastChange[p]) < RS_SEND_INTERVAL)) othersBusy = true;
+    }
+    if (!othersBusy || ((millis() - resyncSince) >= RS_RESYNC_MAX_AGE)) {
+      uint8_t startValue = (highNibble << 4 | lowNibble);
+      rsbus.send8bits(startValue);
+      sentLowNibble = lowNibble;
+      sentHighNibble = highNibble;
+      lastSendTime = millis();
+      resyncWaiting = false;
+      LOG_RS(POORT::nr, startValue);
+      RSCommon.showTransmission();
+    }
+  }
   //
-  // STEP 4: Check if the buffer contains feedback data, and the ISR is ready to send that data via the UART.  
+  // STEP 2: Check if the buffer contains feedback data, and the ISR is ready to send that data via the UART.  
   rsbus.checkConnection();
   //
-  // STEP 5: Maintain the RS LED
-  if (sendLowNibble || sendHighNibble) {
-    digitalWriteFast(LED_FB, HIGH);
-    RSLedTimer.setTime(1000); 
-  } // Step 3: After 1 second turn the LED off
+  // STEP 3: After 1 second turn the FB LED off
   if (RSLedTimer.expired()) {digitalWriteFast(LED_FB, LOW);}
 }
 
+// The three POORTs for which sendChanges() and maintain() are compiled
+template class RSBusClass<poort0>;
+template class RSBusClass<poort1>;
+template class RSBusClass<poort2>;
+
 
 // *******************************************************************************************************
 // TODO: MAY BE REMOVED
@@ -97,7 +143,9 @@ void CommonRSBusClass::test(uint8_t busNr) {
   if ((TNow - TLast) > 500) {
     if (value == 0)  value = 1;
     TLast = TNow;
-    feedback[busNr].rsbus.send4bits(LowBits, value);   // Tell the library to buffer these 8 bits for later sending
+    if (busNr == 0) feedback0.rsbus.send4bits(LowBits, value);
+    if (busNr == 1) feedback1.rsbus.send4bits(LowBits, value);
+    if (busNr == 2) feedback2.rsbus.send4bits(LowBits, value);   // Tell the library to buffer these 8 bits for later sending
     value = value * 2;
     if (value > 16)  value = 1;
   }
@@ -2,11 +2,17 @@
 // File:      RSBus.h
 // Author:    Aiko Pras
 // History:   2024/05/09 AP Version 1.0
+//            2026/10/17 agent Version 1.1: changes are combined per connection, at most once per RS_SEND_INTERVAL
+//            2026/10/17 agent Version 1.2: RSBusClass is a template on the POORT descriptor
+//            2026/10/17 agent Version 1.3: inputs and outputs on one POORT (Dir_Override, Dir_Mask)
+//            2026/10/17 agent Version 1.4: new input changes are sent before resyncs (lastChange per connection, RS_RESYNC_MAX_AGE)
+//            2026/10/17 agent Version 1.5: RS_FEEDBACK_DEADLINE: the deadline of the feedback task
 // 
 // Purpose:   Sending RS-Bus feedback messages
 // 
 // *******************************************************************************************************
 #pragma once
+#include "hardware.h"                      // For the POORT descriptors
 
 
 // To initialise the three RS-Bus addresses
@@ -15,19 +21,50 @@ class CommonRSBusClass {
     void init();
     void checkLed();
     void test(uint8_t busNr);              // TODO: May be removed
+
+    boolean echoOutputs;                   // CV47: report the level of output pins, instead of 0
+    void showTransmission();               // Turns the FB LED on, for changes as well as resyncs
+    unsigned long lastChange[3];           // Per connection: millis() at which it last had a new change
 };
 
 
 // For an individual RS-Bus connection
-class RSBusClass {
+// Changes are not handed to the RS-Bus library immediately, but at most once per RS_SEND_INTERVAL ms.
+// While a change waits, further changes of the same nibble overwrite it; if the nibble returns to the
+// value that was sent last, nothing needs to be sent at all. If both nibbles changed, they are handed
+// over together, with a single send8bits().
+//
+// Input changes have priority over the resync (send8bits of the complete value) that the RS-Bus 
+// library requests after a (re)start or an RS-Bus error. Therefore loop() first calls sendChanges()
+// for all connections, and thereafter maintain(). A resync waits as long as other connections have 
+// changes, so after a bus glitch block occupancy reaches the PC first. To ensure every resync is 
+// completed, it waits at most RS_RESYNC_MAX_AGE ms. 
+// The scheduler runs the feedback task at least every RS_FEEDBACK_DEADLINE ms, well within an RS-Bus
+// poll cycle, such that a nibble is handed to the UART before the next poll of its address.
+#define RS_SEND_INTERVAL    10             // Minimum time (ms) between messages for the same connection
+#define RS_RESYNC_MAX_AGE   100            // Maximum time (ms) a resync waits for changes of others
+#define RS_FEEDBACK_DEADLINE 10            // Maximum time (ms) between two runs of taskFeedback (scheduler.h)
+
+template <class POORT> class RSBusClass {
   public:
-    void check(uint8_t i);                 // i = 0..2 and represents the number of the input port
+    void sendChanges();                    // High priority: new input changes
+    void maintain();                       // Low priority: resync, connection and LED maintenance
 
     RSbusConnection rsbus;
-    uint8_t lowNibble;
+    uint8_t lowNibble;                     // Latest value, derived from the port results
     uint8_t highNibble;
+
+  private:
+    uint8_t sentLowNibble;                 // Value that was last handed to the RS-Bus library
+    uint8_t sentHighNibble;
+    uint8_t echo;                          // Level of the output pins that is included in the nibbles
+    unsigned long lastSendTime;            // millis() of the last send4bits() or send8bits()
+    boolean resyncWaiting;                 // A resync is requested, but waits for changes of others
+    unsigned long resyncSince;             // millis() at which the resync was requested
 };
 
 
 extern CommonRSBusClass RSCommon;
-extern RSBusClass feedback[3];             // we have three RS-Bus connections (0..2)
+extern RSBusClass<poort0> feedback0;       // we have three RS-Bus connections, one for each POORT
+extern RSBusClass<poort1> feedback1;
+extern RSBusClass<poort2> feedback2;
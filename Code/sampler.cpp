@@ -0,0 +1,135 @@
+// *******************************************************************************************************
+// File:      sampler.cpp
+// Author:    agent
+// History:   2026/10/17 agent Version 1.0
+// 
+// Purpose:   Interrupt driven sampling of the three input ports
+// 
+// *******************************************************************************************************
+#include <Arduino.h>                  // For general definitions
+#include <AP_DCC_Decoder_Core.h>      // To include all objects, such as dcc, accCmd, etc.
+#include "hardware.h"                 // Pin assignments and #defines
+#include "extraCVs.h"                 // Numbers of the CVs not defined by AP_DCC_Decoder_Core
+#include "dipSwitches.h"              // The three switches that determine MELDEN or SCHAKELEN
+#include "pulses.h"                   // The same 1 ms tick ends the pulsed outputs
+#include "sampler.h"
+
+samplerClass sampler;
+
+
+void samplerClass::init() {
+  uint8_t value = cvValues.read(Int_Samples);
+  slowInterval = (value == 0) ? 1 : value;
+  adaptive = bitRead(cvValues.read(Input_Mode), INPUT_MODE_ADAPTIVE);
+  value = cvValues.read(Fast_Interval);
+  fastInterval = (adaptive && (value != 0) && (value < slowInterval)) ? value : slowInterval;
+  // Start fast, since after startup all inputs need to be debounced
+  interval = fastInterval;
+  countdown = interval;
+  head = 0;
+  tail = 0;
+  overflows = 0;
+  sleeping = false;
+  edgeSeen = false;
+  // In event mode we need pin change interrupts on all pins that are MELDEN
+  eventMode = bitRead(cvValues.read(Input_Mode), INPUT_MODE_EVENT);
+  setEdgeDetection<poort0>(~dipSwitches.outputs[poort0::nr]);
+  setEdgeDetection<poort1>(~dipSwitches.outputs[poort1::nr]);
+  setEdgeDetection<poort2>(~dipSwitches.outputs[poort2::nr]);
+  // TCA0 is used by DxCore for PWM. We take it over and let it overflow every ms
+  takeOverTCA0();
+  TCA0.SINGLE.CTRLA = 0;                                   // Stop the timer
+  TCA0.SINGLE.CTRLD = 0;                                   // No split mode
+  TCA0.SINGLE.CTRLB = TCA_SINGLE_WGMODE_NORMAL_gc;
+  TCA0.SINGLE.CNT = 0;
+  TCA0.SINGLE.PER = (F_CPU / 64 / 1000) - 1;               // 1 ms
+  TCA0.SINGLE.INTFLAGS = TCA_SINGLE_OVF_bm;
+  TCA0.SINGLE.INTCTRL = TCA_SINGLE_OVF_bm;
+  TCA0.SINGLE.CTRLA = TCA_SINGLE_CLKSEL_DIV64_gc | TCA_SINGLE_ENABLE_bm;
+}
+
+
+void samplerClass::takeSample() {
+  // Read all three ports at the same moment, before we do anything else
+  uint8_t in0 = poort0::vport().IN;
+  uint8_t in1 = poort1::vport().IN;
+  uint8_t in2 = poort2::vport().IN;
+  edgeSeen = false;
+  uint8_t next = (head + 1) & (SAMPLE_BUFFER_SIZE - 1);
+  if (next == tail) {
+    if (overflows < 255) overflows++;
+    return;
+  }
+  buffer[head][0] = in0;
+  buffer[head][1] = in1;
+  buffer[head][2] = in2;
+  times[head] = millis();
+  head = next;                        // Only now the sample becomes visible for read()
+}
+
+
+void samplerClass::tick() {
+  if (sleeping) return;
+  if (--countdown) return;
+  countdown = interval;
+  takeSample();
+}
+
+
+void samplerClass::edgeDetected() {
+  // Called by DxCore's port interrupt, for every edge on one of the MELDEN pins
+  sampler.edgeSeen = true;
+  if (sampler.sleeping) {
+    // Start the debounce window right now. Next samples follow at the normal interval 
+    sampler.sleeping = false;
+    sampler.countdown = sampler.interval;
+    sampler.takeSample();
+  }
+}
+
+
+void samplerClass::idle() {
+  // loop() has processed all samples, and all inputs are stable. 
+  // Only stop sampling if no new samples or edges arrived in the meantime
+  interval = slowInterval;
+  if (!eventMode) return;
+  uint8_t oldSREG = SREG;
+  cli();
+  if ((head == tail) && !edgeSeen) sleeping = true;
+  SREG = oldSREG;
+}
+
+
+void samplerClass::busy() {
+  // One or more inputs are being debounced. Don't wait for the rest of a slow interval
+  if (interval == fastInterval) return;
+  uint8_t oldSREG = SREG;
+  cli();
+  interval = fastInterval;
+  if (countdown > interval) countdown = interval;
+  SREG = oldSREG;
+}
+
+
+uint16_t samplerClass::toSamples(uint8_t value) {
+  // Rounded up, thus the debounce time is never shorter than with fixed rate sampling
+  return ((uint16_t)value * slowInterval + fastInterval - 1) / fastInterval;
+}
+
+
+bool samplerClass::read(uint8_t *sample) {
+  if (tail == head) return false;
+  sample[0] = buffer[tail][0];
+  sample[1] = buffer[tail][1];
+  sample[2] = buffer[tail][2];
+  time = times[tail];
+  tail = (tail + 1) & (SAMPLE_BUFFER_SIZE - 1);
+  return true;
+}
+
+
+ISR(TCA0_OVF_vect) {
+  TCA0.SINGLE.INTFLAGS = TCA_SINGLE_OVF_bm;
+  sampler.tick();
+  pulses.tick();
+}
@@ -0,0 +1,86 @@
+// *******************************************************************************************************
+// File:      sampler.h
+// Author:    agent
+// History:   2026/10/17 agent Version 1.0
+// 
+// Purpose:   Interrupt driven sampling of the three input ports
+//
+// The input pins are no longer sampled from loop(), but from the TCA0 overflow interrupt, which
+// fires every millisecond. Every Int_Samples (CV) ms the ISR reads the IN registers of PORTD, PORTC 
+// and PORTB directly after each other, so all 24 pins are sampled at (almost) the same instant.
+// The samples are stored in a small ring buffer. Since the ISR is the only one that writes to the 
+// buffer (head), and loop() the only one that reads from it (tail), no locking is needed.
+// As long as loop() reads the buffer within SAMPLE_BUFFER_SIZE intervals, no samples will be lost.
+// Should the buffer nevertheless be full, the sample is dropped and the overflows counter incremented.
+//
+// If bit 0 of CV52 (Input_Mode) is set, the sampler operates in event mode. Once loop() has 
+// concluded that all inputs are stable, it calls idle() and the sampler stops taking samples.
+// The pin change interrupts of all input (MELDEN) pins remain active, however. The first edge on any of these
+// pins immediately takes a sample and restarts periodic sampling, so the debounce window starts at 
+// the edge itself, instead of at the next timer slot. Without that bit, fixed rate sampling is used.
+//
+// If bit 1 of CV52 is set, the sampler operates at an adaptive rate. While any input is being 
+// debounced, loop() calls busy() and samples are taken every Fast_Interval (CV49) ms. Once all inputs
+// are stable, idle() returns to Int_Samples ms. This gives a shorter detection latency while trains
+// move, and fewer samples to process while the layout is quiet. When all inputs are stable, the 
+// debounce counters are either reloaded or zero, independent of the rate. Thus only the counting 
+// while debouncing needs to be rescaled: toSamples() converts CV values in units of Int_Samples ms
+// into the number of fast samples. Both modes may be combined.
+//
+// *******************************************************************************************************
+#pragma once
+#include <Arduino.h>
+#include "hardware.h"                  // For the POORT descriptors
+
+#define SAMPLE_BUFFER_SIZE  16         // Must be a power of 2
+
+
+class samplerClass {
+  public:
+    void init();                       // Reads Int_Samples and Input_Mode, and starts the timer
+    bool read(uint8_t *sample);        // copies the oldest 3 port values into sample[0..2]. 
+                                       // Returns false if there is no new sample
+    void idle();                       // All inputs are stable: event mode may stop sampling
+    void busy();                       // An input is being debounced: adaptive mode samples fast
+    uint16_t toSamples(uint8_t value); // Converts a CV in units of Int_Samples into samples
+    template <class POORT> void setEdgeDetection(uint8_t inputs);  // Pin change interrupts for inputs
+    void tick();                       // Called by the timer ISR. Should not be called from elsewhere
+    static void edgeDetected();        // Called by the pin change ISR. Idem
+
+    volatile uint8_t overflows;        // Number of samples dropped, since the buffer was full
+    uint16_t time;                     // millis() (lower 16 bits) of the sample returned by read()
+
+  private:
+    volatile uint8_t buffer[SAMPLE_BUFFER_SIZE][3];
+    volatile uint16_t times[SAMPLE_BUFFER_SIZE];   // When each sample was taken
+    volatile uint8_t head;             // Written by the ISR only
+    volatile uint8_t tail;             // Written by read() only
+    uint8_t interval;                  // Number of ms between samples
+    uint8_t slowInterval;              // Int_Samples
+    uint8_t fastInterval;              // Fast_Interval. Equals Int_Samples if not adaptive
+    uint8_t countdown;                 // Number of ms till the next sample
+    bool eventMode;                    // Set from CV52 (Input_Mode)
+    bool adaptive;                     // Idem
+    volatile bool sleeping;            // Event mode only: no samples are taken till the next edge
+    volatile bool edgeSeen;            // An edge occured after the last sample was taken
+    void takeSample();
+};
+
+
+template <class POORT> void samplerClass::setEdgeDetection(uint8_t inputs) {
+  if (!eventMode) return;
+  for (uint8_t j = 0; j < 8; j++) {
+    if (bitRead(inputs, j)) attachInterrupt(POORT::firstPin + j, edgeDetected, CHANGE);
+      else detachInterrupt(POORT::firstPin + j);
+  }
+  // Pins that just became input must be sampled, even if there is no edge
+  if (inputs) {
+    edgeSeen = true;
+    sleeping = false;
+  }
+}
+
+
+// *******************************************************************************************************
+// Definition of the sampler object, which is declared in sampler.cpp but used by main 
+extern samplerClass sampler;
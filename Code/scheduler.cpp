@@ -0,0 +1,40 @@
+// *******************************************************************************************************
+// File:      scheduler.cpp
+// Author:    agent
+// History:   2026/10/17 agent Version 1.0
+// 
+// Purpose:   Cooperative scheduler for the tasks of loop()
+// 
+// *******************************************************************************************************
+#include <Arduino.h>                  // For general definitions
+#include "profiler.h"                 // To measure the duration of each task
+#include "scheduler.h"
+
+schedulerClass scheduler;
+
+
+void schedulerClass::init() {
+  // setup() may take a while; that should not count as a deadline miss
+  unsigned long now = millis();
+  for (uint8_t i = 0; i < TASKS; i++) lastRun[i] = now;
+  reset();
+}
+
+
+void schedulerClass::reset() {
+  for (uint8_t i = 0; i < TASKS; i++) misses[i] = 0;
+}
+
+
+void schedulerClass::run() {
+  for (uint8_t i = 0; i < TASKS; i++) {
+    unsigned long now = millis();
+    unsigned long elapsed = now - lastRun[i];
+    if (elapsed < tasks[i].period) continue;
+    if ((elapsed > tasks[i].deadline) && (misses[i] < 0xFFFF)) misses[i]++;
+    lastRun[i] = now;
+    PROFILE_START();
+    tasks[i].run();
+    PROFILE_STEP(i);
+  }
+}
@@ -0,0 +1,49 @@
+// *******************************************************************************************************
+// File:      scheduler.h
+// Author:    agent
+// History:   2026/10/17 agent Version 1.0
+// 
+// Purpose:   Cooperative scheduler for the tasks of loop()
+//
+// Previously loop() performed all steps on every pass, thus cheap housekeeping ran as often as the
+// RS-Bus, and a burst of DCC work delayed everything behind it. Now each task has a period and a
+// deadline, in a static table (tasks[] in the main sketch). Each pass of loop(), run() executes 
+// the tasks whose period has passed, in the order of the table. Thus the table order is the priority.
+// A task with period 0 runs on every pass.
+// If a task runs later than its deadline (the time since its previous run), this is counted as a 
+// deadline miss. The misses can be read via PoM: write the task number to CV253 (Sched_Select), 
+// and read CV254 and CV255 (low byte first). Writing 255 to CV253 resets all counters.
+// The task number is the index in tasks[]. The profiler (CV200, see profiler.h) uses the same numbers.
+//
+// *******************************************************************************************************
+#pragma once
+#include <Arduino.h>
+
+#define TASKS               6            // Number of entries in tasks[]
+
+
+struct task_t {
+  void (*run)();
+  uint16_t period;                       // ms between two runs. 0 = every pass of loop()
+  uint16_t deadline;                     // ms after the previous run, after which the run is late
+};
+
+
+class schedulerClass {
+  public:
+    void init();                         // Should be called at the end of setup()
+    void run();                          // Should be called from loop()
+    void reset();                        // Clears the deadline miss counters
+
+    uint16_t misses[TASKS];              // Per task: the number of runs after the deadline
+
+  private:
+    unsigned long lastRun[TASKS];        // millis() of the previous run of each task
+};
+
+
+// *******************************************************************************************************
+// Definition of the scheduler object, which is declared in scheduler.cpp but used elsewhere.
+// The task table is defined in the main sketch.
+extern schedulerClass scheduler;
+extern const task_t tasks[TASKS];
@@ -0,0 +1,128 @@
+// *******************************************************************************************************
+// File:      virtualCVs.cpp
+// Author:    agent
+// History:   2026/10/17 agent Version 1.0
+// 
+// Purpose:   Read-only CVs that reflect the internal state of the decoder
+// 
+// *******************************************************************************************************
+#include <AP_DCC_Decoder_Core.h>      // To include all objects, such as dcc, accCmd, etc.
+#include "extraCVs.h"                 // Numbers of the CVs not defined by AP_DCC_Decoder_Core
+#include "profiler.h"                 // Duration of the steps in loop()
+#include "hardware.h"                 // To find the POORT and bit of an IO pin
+#include "dipSwitches.h"              // The DIP switch settings
+#include "dccIn.h"                    // Number of accessory commands
+#include "input.h"                    // Diagnostic counters of the input pins
+#include "scheduler.h"                // Deadline misses of the tasks of loop()
+#include "virtualCVs.h"
+
+virtualCvClass virtualCVs;
+
+
+bool virtualCvClass::isRange(uint16_t first, uint16_t last) {
+  return ((cvCmd.number >= first) && (cvCmd.number <= last));
+}
+
+
+void virtualCvClass::init() {
+  pomFeedback.address = RS_POM_ADDRESS;
+}
+
+
+void virtualCvClass::check() {
+  pomFeedback.checkConnection();
+}
+
+
+bool virtualCvClass::isRepeat() {
+  return ((cvCmd.number == lastCv) && ((millis() - lastTime) < RS_POM_REPEAT));
+}
+
+
+void virtualCvClass::newSelection() {
+  // The read-only CVs now return other values: the next read is no repeat, and nothing is latched
+  lastCv = 0;
+  latchedCv = 0;
+}
+
+
+bool virtualCvClass::reply(uint8_t value) {
+  // Reads are answered from RAM, the value is not stored. Writes are ignored
+  if (cvCmd.operation != CvAccess::verifyByte) return true;
+  if (isRepeat()) return true;
+  lastCv = cvCmd.number;
+  lastTime = millis();
+  pomFeedback.send8bits(value);
+  return true;
+}
+
+
+bool virtualCvClass::reply16(uint16_t value, uint16_t first) {
+  // A repeat of the low byte read is not answered, thus should not latch a newer value either
+  if ((cvCmd.operation == CvAccess::verifyByte) && !isRepeat()) {
+    if (cvCmd.number == first) {
+      latched = value;
+      latchedCv = first;
+    }
+    else if (latchedCv == first) value = latched;
+  }
+  if (cvCmd.number == first) return reply(lowByte(value));
+  return reply(highByte(value));
+}
+
+
+bool virtualCvClass::snapshot() {
+  uint8_t index = cvCmd.number - Snap_In;
+  uint8_t p = index % 3;
+  if (cvCmd.number == Snap_Dip) return reply(dipSwitches.state());
+  if (cvCmd.number >= Snap_Result) return reply(port[p].result);
+  if (cvCmd.number >= Snap_Out) return reply(poortRegisters[p]->OUT);
+  return reply(poortRegisters[p]->IN);
+}
+
+
+bool virtualCvClass::diagnostics() {
+  if (cvCmd.number == Diag_Select) {
+    if (cvCmd.operation != CvAccess::writeByte) return reply(diagPin);
+    if (cvCmd.value == 255) {for (uint8_t p = 0; p < 3; p++) port[p].resetDiagnostics();}
+      else if ((cvCmd.value >= 1) && (cvCmd.value <= 24)) diagPin = cvCmd.value;
+    newSelection();
+    return true;
+  }
+  if ((diagPin < 1) || (diagPin > 24)) return reply(0);
+  const ioPinMap_t &map = ioPinMap[diagPin - 1];
+  portClass &input = port[map.poort];
+  uint8_t j = 0;
+  while (!(map.bitMask & bit(j))) j++;
+  if (cvCmd.number < Diag_Spikes) return reply16(input.edges[j], Diag_Edges);
+  if (cvCmd.number < Diag_HoldOffs) return reply16(input.spikes[j], Diag_Spikes);
+  if (cvCmd.number < Diag_Transitions) return reply16(input.holdOffs[j], Diag_HoldOffs);
+  return reply16(input.transitions[j], Diag_Transitions);
+}
+
+
+bool virtualCvClass::handled() {
+  #if defined(PROFILING)
+  if (isRange(Prof_Select, Prof_Last)) {
+    if ((cvCmd.number == Prof_Select) && (cvCmd.operation == CvAccess::writeByte)) {
+      profiler.select(cvCmd.value);
+      newSelection();
+      return true;
+    }
+    return reply(profiler.cvValue(cvCmd.number - Prof_Select));
+  }
+  #endif
+  if (isRange(Snap_In, Snap_Dip)) return snapshot();
+  if (isRange(Acc_Applied, Acc_Applied + 1)) return reply16(dcc_in.applied, Acc_Applied);
+  if (isRange(Acc_Suppressed, Acc_Suppressed + 1)) return reply16(dcc_in.suppressed, Acc_Suppressed);
+  if (isRange(Diag_Select, Diag_Transitions + 1)) return diagnostics();
+  if (cvCmd.number == Sched_Select) {
+    if (cvCmd.operation != CvAccess::writeByte) return reply(task);
+    if (cvCmd.value == 255) scheduler.reset();
+      else if (cvCmd.value < TASKS) task = cvCmd.value;
+    newSelection();
+    return true;
+  }
+  if (isRange(Sched_Misses, Sched_Misses + 1)) return reply16(scheduler.misses[task], Sched_Misses);
+  return false;
+}
@@ -0,0 +1,54 @@
+// *******************************************************************************************************
+// File:      virtualCVs.h
+// Author:    agent
+// History:   2026/10/17 agent Version 1.0
+// 
+// Purpose:   Read-only CVs that reflect the internal state of the decoder
+//
+// The AP_DCC_Decoder_Core library answers PoM read (verify) requests with the value that is stored
+// for that CV in EEPROM. The read-only CVs listed in extraCVs.h change all the time, thus storing
+// them would wear the EEPROM and block the DCC path. Therefore PoM reads of these CVs are not given
+// to the library, but answered from RAM via our own connection to RS-Bus address 128.
+// 16-bit values are read as two CVs, low byte first. Reading the low byte latches the value, thus
+// the high byte that is read thereafter belongs to the same value.
+// Command stations repeat PoM messages; a repeat that follows within RS_POM_REPEAT ms is ignored.
+// PoM writes to select CVs are stored in RAM; PoM writes to the other read-only CVs are ignored.
+// After a select CV is written, the next read is answered even if it reads the same CV as before.
+//
+// *******************************************************************************************************
+#pragma once
+#include <Arduino.h>
+#include <AP_DCC_Decoder_Core.h>       // For RSbusConnection
+
+#define RS_POM_ADDRESS      128        // RS-Bus address for PoM feedback messages
+#define RS_POM_REPEAT       100        // ms within which the same PoM read is considered a repeat
+
+
+class virtualCvClass {
+  public:
+    bool handled();        // Should be called for each PoM message. If it returns true, the message 
+                           // is completely handled and should not be given to cvProgramming
+    void init();
+    void check();          // Should be called from loop(), to send the PoM feedback
+
+  private:
+    bool isRange(uint16_t first, uint16_t last);
+    bool isRepeat();       // The PoM read is a repeat of the previous one, which was answered already
+    void newSelection();   // Called after a write to a select CV
+    bool reply(uint8_t value);
+    bool reply16(uint16_t value, uint16_t first);    // first = CV that holds the low byte
+    RSbusConnection pomFeedback;                     // RS-Bus address 128
+    uint16_t latched;      // The 16-bit value of which the low byte was read last
+    uint16_t latchedCv;    // The CV of that low byte. 0 = nothing latched
+    uint16_t lastCv;       // The CV of the last PoM read, to detect repeats
+    unsigned long lastTime;
+    bool snapshot();
+    bool diagnostics();
+    uint8_t diagPin;       // Diag_Select: the IO pin (1..24) of which the counters are returned
+    uint8_t task;          // Sched_Select: the task of which the deadline misses are returned
+};
+
+
+// *******************************************************************************************************
+// Definition of the virtualCVs object, which is declared in virtualCVs.cpp but used by dccIn.cpp
+extern virtualCvClass virtualCVs;
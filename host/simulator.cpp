@@ -0,0 +1,233 @@
+// *******************************************************************************************************
+// File:      simulator.cpp
+// Author:    agent
+// History:   2026/10/17 agent Version 1.0
+//
+// Purpose:   Runs the decoder sketch (setup() and loop() of Code.ino) on a host, with a simulated clock
+//
+// *******************************************************************************************************
+#include <Arduino.h>
+#include <AP_DCC_Decoder_Core.h>
+#include <string.h>
+#include "hardware.h"                 // For the IO pin map
+#include "myDefaults.h"               // For the CV defaults of this board
+#include "simulator.h"
+
+void setup();                         // The sketch
+void loop();
+
+
+simClass &simulator() {
+  static simClass instance;
+  return instance;
+}
+
+
+simClass::simClass() {
+  memset(eeprom, 0xFF, sizeof(eeprom));         // A new chip
+  ports[0].external = 0xFF;                     // Pull-ups of the DIP switches: all MELDEN
+}
+
+
+// *******************************************************************************************************
+void simClass::factoryReset() {
+  cvValues.init(TMC24ChannelIODecoder, 0);
+  myDefaults.init();
+  cvValues.setDefaults();
+}
+
+
+void simClass::setCv(uint16_t cv, uint8_t value) {
+  eeprom[cv] = value;
+}
+
+
+void simClass::powerUp() {
+  setup();
+}
+
+
+// *******************************************************************************************************
+// Time
+void simClass::at(unsigned long time, std::function<void()> event) {
+  events.emplace(time, event);
+}
+
+
+unsigned long simClass::nextPoll() {
+  return cycleStart + nextAddress * RS_POLL_SPACING;
+}
+
+
+void simClass::advance(unsigned long us) {
+  // Handles the timer interrupts, RS-Bus polls and scheduled events in the order of their time
+  unsigned long target = now + us;
+  for (;;) {
+    unsigned long next = target;
+    if (nextTick < next) next = nextTick;
+    if (nextPoll() < next) next = nextPoll();
+    if (!events.empty() && (events.begin()->first < next)) next = events.begin()->first;
+    if (next >= target) break;
+    now = next;
+    if (!events.empty() && (events.begin()->first == now)) {
+      std::function<void()> event = events.begin()->second;
+      events.erase(events.begin());
+      event();
+    }
+    else if (nextTick == now) {
+      nextTick += 1000;
+      if ((TCA0.SINGLE.CTRLA & TCA_SINGLE_ENABLE_bm) && (TCA0.SINGLE.INTCTRL & TCA_SINGLE_OVF_bm)) TCA0_OVF_vect();
+    }
+    else {
+      poll(nextAddress);
+      if (++nextAddress > 128) {
+        nextAddress = 1;
+        cycleStart += rsCycle;
+      }
+    }
+  }
+  now = target;
+}
+
+
+void simClass::run(unsigned long us) {
+  unsigned long end = now + us;
+  while (now < end) {
+    loop();
+    loops++;
+    advance(loopCost);
+  }
+}
+
+
+// *******************************************************************************************************
+// DCC packets
+void simClass::packet(const std::vector<uint8_t> &bytes) {
+  packet_t received = {now, {}, 0};
+  uint8_t check = 0;
+  for (uint8_t b : bytes) {
+    received.data[received.size++] = b;
+    check ^= b;
+  }
+  received.data[received.size++] = check;
+  packets.push_back(received);
+}
+
+
+void simClass::accessory(unsigned int switchAddress, uint8_t position) {
+  // Basic accessory packet: {10AAAAAA} {1AAACDDD}, with the activate bit (C) set
+  unsigned int decoderAddress = (switchAddress - 1) / 4 + 1;
+  uint8_t turnout = (switchAddress - 1) % 4;
+  packet({uint8_t(0x80 | (decoderAddress & 0x3F)),
+          uint8_t(0x88 | ((~decoderAddress >> 2) & 0x70) | (turnout << 1) | (position ? 1 : 0))});
+}
+
+
+void simClass::extended(unsigned int address, uint8_t aspect) {
+  // Extended accessory packet: {10AAAAAA} {0AAA0AA1} {XXXXXXXX}
+  packet({uint8_t(0x80 | ((address >> 2) & 0x3F)),
+          uint8_t(0x01 | ((~address >> 4) & 0x70) | ((address & 0x03) << 1)), aspect});
+}
+
+
+static std::vector<uint8_t> pomPacket(uint8_t operation, uint16_t cv, uint8_t value) {
+  // PoM to the loco address Offset_PoM * 100 + RS-Bus address: {address} {1110CCVV} {VVVVVVVV} {DDDDDDDD}
+  unsigned int address = cvValues.read(Offset_PoM) * 100 + cvValues.read(myRSAddr);
+  std::vector<uint8_t> bytes;
+  if (address <= 127) bytes.push_back(address);
+    else {
+      bytes.push_back(0xC0 | (address >> 8));
+      bytes.push_back(address & 0xFF);
+    }
+  bytes.push_back(0xE0 | (operation << 2) | (((cv - 1) >> 8) & 0x03));
+  bytes.push_back((cv - 1) & 0xFF);
+  bytes.push_back(value);
+  return bytes;
+}
+
+
+void simClass::pomRead(uint16_t cv) {
+  packet(pomPacket(1, cv, 0));
+}
+
+
+void simClass::pomWrite(uint16_t cv, uint8_t value) {
+  packet(pomPacket(3, cv, value));
+}
+
+
+// *******************************************************************************************************
+// Pins. POORT0..2 are PORTD, PORTC and PORTB; the DIP switches are on PA4..PA6
+void simClass::setDip(uint8_t dip, uint8_t setting) {
+  uint8_t oldIn = (ports[0].out & ports[0].dir) | (ports[0].external & ~ports[0].dir);
+  bitWrite(ports[0].external, 3 + dip, setting == MELDEN);
+  pinChanged(0, oldIn);
+}
+
+
+void simClass::setInput(uint8_t ioPin, uint8_t level) {
+  const ioPinMap_t &map = ioPinMap[ioPin - 1];
+  port_t &port = ports[3 - map.poort];
+  uint8_t oldIn = (port.out & port.dir) | (port.external & ~port.dir);
+  if (level) port.external |= map.bitMask;
+    else port.external &= ~map.bitMask;
+  pinChanged(3 - map.poort, oldIn);
+}
+
+
+void simClass::setInputs(uint8_t poort, uint8_t value) {
+  port_t &port = ports[3 - poort];
+  uint8_t oldIn = (port.out & port.dir) | (port.external & ~port.dir);
+  port.external = value;
+  pinChanged(3 - poort, oldIn);
+}
+
+
+uint8_t simClass::pin(uint8_t ioPin) {
+  const ioPinMap_t &map = ioPinMap[ioPin - 1];
+  const port_t &port = ports[3 - map.poort];
+  uint8_t in = (port.out & port.dir) | (port.external & ~port.dir);
+  return (in & map.bitMask) ? HIGH : LOW;
+}
+
+
+uint8_t simClass::dir(uint8_t poort) {
+  return ports[3 - poort].dir;
+}
+
+
+uint8_t simClass::led(uint8_t arduinoPin) {
+  return bitRead(ports[arduinoPin / 8].out, arduinoPin % 8);
+}
+
+
+void simClass::pinChanged(uint8_t port, uint8_t oldIn) {
+  // Pin change interrupts, for every pin whose level changed
+  port_t &p = ports[port];
+  uint8_t edges = oldIn ^ ((p.out & p.dir) | (p.external & ~p.dir));
+  for (uint8_t j = 0; j < 8; j++) {
+    if (bitRead(edges, j) && p.isr[j]) p.isr[j]();
+  }
+}
+
+
+// *******************************************************************************************************
+// RS-Bus
+void simClass::rsBusError() {
+  for (RSbusConnection *connection : connections) {
+    connection->buffer.clear();
+    connection->uart.clear();
+    connection->feedbackRequested = true;
+  }
+}
+
+
+void simClass::poll(uint8_t address) {
+  for (RSbusConnection *connection : connections) {
+    if ((connection->address != address) || connection->uart.empty()) continue;
+    const RSbusConnection::nibble_t &nibble = connection->uart.front();
+    rsBus.push_back({now, nibble.queued, address, nibble.type, nibble.value});
+    connection->uart.pop_front();
+    return;                           // One transmission per poll
+  }
+}
@@ -0,0 +1,118 @@
+// *******************************************************************************************************
+// File:      simulator.h
+// Author:    agent
+// History:   2026/10/17 agent Version 1.0
+//
+// Purpose:   Runs the decoder sketch (setup() and loop() of Code.ino) on a host, with a simulated clock
+//
+// The sketch is compiled unchanged against the stand-ins in host/stubs. The simulator owns the state
+// behind these stand-ins: the clock, the I/O ports, the EEPROM, the DCC packets that are received and
+// the RS-Bus. Tests and benchmarks use it as follows:
+//   simClass &sim = simulator();
+//   sim.factoryReset();                    // optional: CV defaults, as after a long button push
+//   sim.setCv(Input_Mode, 1);              // optional: CVs that were programmed before
+//   sim.powerUp();                         // calls setup()
+//   sim.accessory(529, HIGH);              // inject a DCC packet, or schedule one with sim.at()
+//   sim.setInput(17, HIGH);                // drive an input pin
+//   sim.run(100000);                       // 100 ms of loop() passes, timer interrupts and RS-Bus polls
+// and afterwards inspect pinWrites, rsSent and rsBus.
+//
+// Time model:
+// - every pass of loop() takes loopCost us. Interrupts and scheduled events happen between passes,
+//   at their exact time. Serial output that does not fit in the transmit buffer blocks, as on the AVR.
+// - the TCA0 overflow interrupt (sampler and pulses) fires every 1000 us.
+// - the RS-Bus master polls address n (1..128) at n * RS_POLL_SPACING us after the start of a cycle
+//   of rsCycle us. A connection transmits at most one nibble per poll of its address.
+// These are models: the host cannot say how long loop() takes on the AVR. Set loopCost to a
+// value measured with the profiler (profiler.h) to get realistic numbers.
+//
+// The simulator holds one decoder, since the sketch uses global objects. Likewise, setup() can only
+// be called once: each test that needs its own power-up runs in its own process.
+//
+// *******************************************************************************************************
+#pragma once
+#include <Arduino.h>
+#include <AP_DCC_Decoder_Core.h>
+#include <functional>
+#include <map>
+#include <string>
+#include <vector>
+
+#define SIM_EEPROM_SIZE     512                // AVR64DA64
+#define SIM_EEPROM_BUSY     4000               // us that the EEPROM is busy after a write
+#define SIM_SERIAL_BUFFER   64                 // bytes in the UART transmit buffer
+#define SIM_SERIAL_BYTE     87                 // us per byte at 115200 baud (10 bits per byte)
+#define RS_POLL_SPACING     100                // us between the polls of two consecutive addresses
+
+
+class simClass {
+  public:
+    simClass();
+
+    // Before power-up
+    void factoryReset();                       // All CVs get their default value
+    void setCv(uint16_t cv, uint8_t value);    // As if the CV was programmed before
+    void powerUp();                            // Calls setup()
+
+    // Running the sketch
+    void run(unsigned long us);                // loop() passes for the given time
+    void at(unsigned long time, std::function<void()> event);   // Schedules an event (us since power-up)
+    void advance(unsigned long us);            // Moves the clock, with interrupts and events, without loop()
+    unsigned long now = 0;                     // us since power-up
+    unsigned int loopCost = 20;                // us per pass of loop()
+    unsigned long loops = 0;                   // Number of passes of loop()
+
+    // DCC packets. They are received now; use at() to receive them later
+    void packet(const std::vector<uint8_t> &bytes);           // Without the error detection byte
+    void accessory(unsigned int switchAddress, uint8_t position);    // Switch address 1..2044
+    void extended(unsigned int address, uint8_t aspect);      // 11-bit extended accessory address
+    void pomRead(uint16_t cv);                 // To the PoM address of this decoder (CV37 and CV10)
+    void pomWrite(uint16_t cv, uint8_t value);
+
+    // Pins
+    void setDip(uint8_t dip, uint8_t setting); // DIP switch 1..3: MELDEN or SCHAKELEN
+    void setInput(uint8_t ioPin, uint8_t level);               // IO pin 1..24 of the SUB-D connector
+    void setInputs(uint8_t poort, uint8_t value);              // All 8 pins of POORT 0..2, AVR bit order
+    uint8_t pin(uint8_t ioPin);                // Level of IO pin 1..24 (driven or external)
+    uint8_t dir(uint8_t poort);                // DIR register of POORT 0..2
+    uint8_t led(uint8_t arduinoPin);           // Level of a LED pin
+
+    // RS-Bus
+    void rsBusError();                         // All connections lose their data and request a resync
+    unsigned long rsCycle = 20000;             // us per poll cycle of the RS-Bus master
+
+    // What the decoder did
+    struct pinWrite_t {unsigned long time; uint8_t poort; uint8_t out;};
+    std::vector<pinWrite_t> pinWrites;         // Every change of the OUT register of a POORT
+    struct rsSent_t {unsigned long time; uint8_t address; uint8_t type; uint8_t value;};
+    std::vector<rsSent_t> rsSent;              // send4bits() (type LowBits / HighBits), send8bits() (type 2)
+    struct rsBus_t {unsigned long time; unsigned long queued; uint8_t address; uint8_t type; uint8_t value;};
+    std::vector<rsBus_t> rsBus;                // Nibbles transmitted on the RS-Bus
+    std::string serial;                        // Everything printed on the serial monitor
+    unsigned long eepromWrites[SIM_EEPROM_SIZE] = {};
+
+    // State behind the stand-ins in host/stubs. Not for use by tests
+    struct port_t {uint8_t dir, out, external; void (*isr[8])();};
+    port_t ports[SIM_PORTS] = {};
+    uint8_t eeprom[SIM_EEPROM_SIZE];
+    unsigned long eepromBusyUntil = 0;
+    unsigned long serialFreeAt = 0;            // us at which the UART transmit buffer is empty
+    struct packet_t {unsigned long time; uint8_t data[6]; uint8_t size;};
+    std::vector<packet_t> packets;             // Received, but not yet read by dcc.input()
+    std::vector<RSbusConnection *> connections;
+    void pinChanged(uint8_t port, uint8_t oldIn);
+
+  private:
+    void poll(uint8_t address);
+    unsigned long nextPoll();                  // us of the next RS-Bus poll
+    unsigned long nextTick = 1000;             // us of the next TCA0 overflow
+    unsigned long cycleStart = 0;              // us at which the current RS-Bus poll cycle started
+    uint8_t nextAddress = 1;                   // Address of the next RS-Bus poll
+    std::multimap<unsigned long, std::function<void()>> events;
+};
+
+
+// *******************************************************************************************************
+// The simulator object. It is created on first use, since the global objects of the sketch
+// (such as the RS-Bus connections) already need it while they are constructed
+simClass &simulator();
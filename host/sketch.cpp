@@ -0,0 +1,17 @@
+// *******************************************************************************************************
+// File:      sketch.cpp
+// Author:    agent
+// History:   2026/10/17 agent Version 1.0
+//
+// Purpose:   Compiles the main sketch (Code.ino) for the host. The Arduino IDE does the same, after it
+//            adds #include <Arduino.h>, which Code.ino already has
+//
+// *******************************************************************************************************
+#include "../Code/Code.ino"
+
+
+// The sources in Code declare these objects (hardware.h, dccIn.h and myDefaults.h), but none of them
+// defines them
+ledClass leds;
+dcc_in_class dcc_in;
+myDefaults_class myDefaults;
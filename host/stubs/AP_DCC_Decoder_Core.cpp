@@ -0,0 +1,191 @@
+// *******************************************************************************************************
+// File:      AP_DCC_Decoder_Core.cpp
+// Author:    agent
+// History:   2026/10/17 agent Version 1.0
+//
+// Purpose:   Host stand-in for the AP_DCC_Decoder_Core library. All state lives in the simulator
+//
+// *******************************************************************************************************
+#include <AP_DCC_Decoder_Core.h>
+#include <EEPROM.h>
+#include <algorithm>
+#include "simulator.h"
+
+Dcc dcc;
+Accessory accCmd;
+Loco locoCmd;
+CvValues cvValues;
+CvAccess cvCmd;
+CvProgramming cvProgramming;
+DecoderHardware decoderHardware;
+DccMessage dccMessage;
+RSbusHardware rsbusHardware;
+
+static RSbusConnection pomReply;              // The library answers PoM reads via RS-Bus address 128
+
+
+// *******************************************************************************************************
+// CVs are stored in EEPROM: CV n at address n
+void CvValues::init(uint8_t decoderType, uint8_t softwareVersion) {
+  for (uint16_t i = 0; i < 256; i++) defaults[i] = 0;
+  defaults[myAddrL] = 1;
+  defaults[myAddrH] = 0;
+  defaults[myRSAddr] = 1;
+  defaults[Offset_PoM] = 50;                  // PoM address = 5000 + RS-Bus address
+  defaults[Min_1Samples] = 3;
+  defaults[Min_0Samples] = 150;
+  defaults[Int_Samples] = 10;
+  defaults[Start_Delay] = 20;
+}
+
+
+uint8_t CvValues::read(uint16_t number) {
+  return EEPROM.read(number);
+}
+
+
+void CvValues::write(uint16_t number, uint8_t value) {
+  EEPROM.update(number, value);
+}
+
+
+void CvValues::setDefaults() {
+  for (uint16_t i = 0; i < 256; i++) write(i, defaults[i]);
+}
+
+
+bool CvValues::addressNotSet() {
+  return (read(myAddrL) == 0) && (read(myAddrH) == 0);
+}
+
+
+unsigned int CvValues::storedAddress() {
+  return read(myAddrL) + 64 * read(myAddrH);
+}
+
+
+// *******************************************************************************************************
+// DCC packets
+void Accessory::setMyAddress(unsigned int first, unsigned int last) {
+  myMinAddress = first;
+  myMaxAddress = last;
+}
+
+
+void Loco::setMyAddress(unsigned int address) {
+  myAddress = address;
+}
+
+
+bool Dcc::input() {
+  // Takes the oldest packet that has been received, and decodes it as the library does
+  simClass &sim = simulator();
+  if (sim.packets.empty() || (sim.packets.front().time > sim.now)) return false;
+  const simClass::packet_t packet = sim.packets.front();
+  sim.packets.erase(sim.packets.begin());
+  std::copy(packet.data, packet.data + packet.size, dccMessage.data);
+  dccMessage.size = packet.size;
+  const uint8_t *data = packet.data;
+  cmdType = IgnoreCmd;
+  if (((data[0] & 0xC0) == 0x80) && (data[1] & 0x80)) {
+    // Basic accessory packet: {10AAAAAA} {1AAACDDD}
+    accCmd.decoderAddress = (data[0] & 0x3F) | ((~data[1] & 0x70) << 2);
+    accCmd.turnout = ((data[1] >> 1) & 0x03) + 1;
+    accCmd.position = data[1] & 0x01;
+    accCmd.outputAddress = (accCmd.decoderAddress - 1) * 4 + accCmd.turnout;
+    if ((accCmd.decoderAddress >= accCmd.myMinAddress) && (accCmd.decoderAddress <= accCmd.myMaxAddress))
+      cmdType = MyAccessoryCmd;
+      else cmdType = AnyAccessoryCmd;
+    return true;
+  }
+  // Multi function decoder packet: short (1..127) or long address, followed by the instruction
+  unsigned int address;
+  uint8_t next;
+  if ((data[0] >= 1) && (data[0] <= 127)) {address = data[0]; next = 1;}
+    else if ((data[0] >= 0xC0) && (data[0] <= 0xE7)) {address = ((data[0] & 0x3F) << 8) | data[1]; next = 2;}
+    else return true;
+  if ((address != locoCmd.myAddress) || (packet.size < next + 4)) return true;
+  if ((data[next] & 0xF0) != 0xE0) return true;
+  // PoM: {1110CCVV} {VVVVVVVV} {DDDDDDDD}
+  uint8_t operation = (data[next] >> 2) & 0x03;
+  if (operation == 0) return true;
+  cvCmd.operation = (operation == 1) ? CvAccess::verifyByte :
+                    (operation == 3) ? CvAccess::writeByte : CvAccess::bitManipulation;
+  cvCmd.number = (((data[next] & 0x03) << 8) | data[next + 1]) + 1;
+  cvCmd.value = data[next + 2];
+  cmdType = MyPomCmd;
+  return true;
+}
+
+
+void CvProgramming::processMessage(Dcc::CmdType_t cmdType) {
+  // Service mode is not modelled
+  if (cmdType != Dcc::MyPomCmd) return;
+  if (cvCmd.operation == CvAccess::writeByte) cvValues.write(cvCmd.number, cvCmd.value);
+  if (cvCmd.operation == CvAccess::verifyByte) pomReply.send8bits(cvValues.read(cvCmd.number));
+}
+
+
+void DecoderHardware::init() {
+  pomReply.address = 128;
+  pomReply.feedbackRequested = false;
+}
+
+
+void DecoderHardware::update() {
+  pomReply.checkConnection();
+}
+
+
+// *******************************************************************************************************
+// Timers
+void DccTimer::setTime(unsigned long ms) {
+  deadline = millis() + ms;
+  running = true;
+}
+
+
+bool DccTimer::expired() {
+  if (!running || (millis() < deadline)) return false;
+  running = false;
+  return true;
+}
+
+
+// *******************************************************************************************************
+// RS-Bus. The master (see simulator.cpp) takes the nibble from the UART when it polls our address
+RSbusConnection::RSbusConnection() {
+  simulator().connections.push_back(this);
+}
+
+
+RSbusConnection::~RSbusConnection() {
+  std::vector<RSbusConnection *> &list = simulator().connections;
+  list.erase(std::remove(list.begin(), list.end(), this), list.end());
+}
+
+
+void RSbusConnection::send4bits(uint8_t nibbleType, uint8_t value) {
+  simClass &sim = simulator();
+  sim.rsSent.push_back({sim.now, address, nibbleType, uint8_t(value & 0x0F)});
+  buffer.push_back({nibbleType, uint8_t(value & 0x0F), sim.now});
+  maxDepth = std::max<unsigned int>(maxDepth, buffer.size() + uart.size());
+}
+
+
+void RSbusConnection::send8bits(uint8_t value) {
+  simClass &sim = simulator();
+  sim.rsSent.push_back({sim.now, address, 2, value});
+  buffer.push_back({LowBits, uint8_t(value & 0x0F), sim.now});
+  buffer.push_back({HighBits, uint8_t(value >> 4), sim.now});
+  maxDepth = std::max<unsigned int>(maxDepth, buffer.size() + uart.size());
+  feedbackRequested = false;
+}
+
+
+void RSbusConnection::checkConnection() {
+  if (uart.empty() && !buffer.empty()) {
+    uart.push_back(buffer.front());
+    buffer.pop_front();
+  }
+}
@@ -0,0 +1,151 @@
+// *******************************************************************************************************
+// File:      AP_DCC_Decoder_Core.h
+// Author:    agent
+// History:   2026/10/17 agent Version 1.0
+//
+// Purpose:   Host stand-in for the AP_DCC_Decoder_Core library, used by the simulation harness
+//
+// The objects have the names and members the decoder sketch uses; their behaviour is a model:
+// - dcc.input() returns the DCC packets the simulator injected, one per call. Accessory and PoM
+//   packets are decoded into accCmd and cvCmd in the same way as the library does.
+// - cvValues keeps the CVs in the simulated EEPROM (CV n at EEPROM address n).
+// - RSbusConnection buffers the nibbles of send4bits() and send8bits(). checkConnection() hands the
+//   next nibble to the "UART", which transmits it when the modelled RS-Bus master polls the address
+//   (see simulator.h). After power-up every connection requests a resync (feedbackRequested).
+// - cvProgramming answers PoM reads with the stored value, via the library's own RS-Bus address 128.
+//
+// *******************************************************************************************************
+#pragma once
+#include <Arduino.h>
+#include <deque>
+
+// CVs of the TMC24ChannelIODecoder, as far as the sketch uses them
+#define myAddrL             1
+#define myAddrH             9
+#define myRSAddr            10
+#define Offset_PoM          37
+#define Int_Samples         35
+#define Start_Delay         36
+#define Min_1Samples        33
+#define Min_0Samples        34
+#define TMC24ChannelIODecoder 0x30
+
+
+class CvValues {
+  public:
+    void init(uint8_t decoderType, uint8_t softwareVersion);
+    uint8_t read(uint16_t number);
+    void write(uint16_t number, uint8_t value);
+    void setDefaults();                          // Factory reset: copies defaults[] to EEPROM
+    bool addressNotSet();
+    unsigned int storedAddress();                // Decoder address from CV1 and CV9
+    uint8_t defaults[256];
+};
+
+
+class Dcc {
+  public:
+    enum CmdType_t {IgnoreCmd, ResetCmd, MyLocoSpeedCmd, MyLocoF0F4Cmd, AnyAccessoryCmd, MyAccessoryCmd,
+                    MyPomCmd, MyEmergencyStopCmd, SmCmd, SomeLocoMovesFlag};
+    bool input();                                // true if a new packet was received
+    CmdType_t cmdType;
+};
+
+
+class Accessory {
+  public:
+    void setMyAddress(unsigned int first, unsigned int last);
+    unsigned int decoderAddress;                 // 0..511
+    uint8_t turnout;                             // 1..4
+    uint8_t position;                            // 0 = -, 1 = +
+    unsigned int outputAddress;                  // Switch address as shown to the user
+    unsigned int myMinAddress;
+    unsigned int myMaxAddress;
+};
+
+
+class Loco {
+  public:
+    void setMyAddress(unsigned int address);
+    unsigned int myAddress;
+};
+
+
+class CvAccess {
+  public:
+    enum {verifyByte, writeByte, bitManipulation};
+    uint16_t number;                             // 1..1024
+    uint8_t value;
+    uint8_t operation;
+};
+
+
+class CvProgramming {
+  public:
+    void processMessage(Dcc::CmdType_t cmdType);
+};
+
+
+class DecoderHardware {
+  public:
+    void init();
+    void update();
+};
+
+
+struct DccMessage {
+  uint8_t data[6];
+  uint8_t size;
+};
+
+
+class DccTimer {
+  public:
+    void setTime(unsigned long ms);              // Starts the timer
+    bool expired();                              // true once, after the time has passed
+  private:
+    unsigned long deadline;
+    bool running = false;
+};
+
+
+#define LowBits             0
+#define HighBits            1
+
+class RSbusConnection {
+  public:
+    RSbusConnection();
+    ~RSbusConnection();
+    void send4bits(uint8_t nibbleType, uint8_t value);
+    void send8bits(uint8_t value);
+    void checkConnection();
+    uint8_t address = 0;                         // 1..128. 0 = not used
+    bool feedbackRequested = true;               // A resync is needed, after power-up or a bus error
+
+    // The model of the library buffer and the UART (see simulator.cpp)
+    struct nibble_t {
+      uint8_t type;                              // LowBits or HighBits
+      uint8_t value;
+      unsigned long queued;                      // us at which send4bits() or send8bits() was called
+    };
+    std::deque<nibble_t> buffer;                 // Nibbles that wait for checkConnection()
+    std::deque<nibble_t> uart;                   // Nibble that waits for the poll of our address
+    unsigned int maxDepth = 0;                   // Maximum number of nibbles waiting
+};
+
+
+class RSbusHardware {
+  public:
+    bool rsSignalIsOK = true;
+};
+
+
+extern Dcc dcc;
+extern Accessory accCmd;
+extern Loco locoCmd;
+extern CvValues cvValues;
+extern CvAccess cvCmd;
+extern CvProgramming cvProgramming;
+extern DecoderHardware decoderHardware;
+extern DccMessage dccMessage;
+extern RSbusHardware rsbusHardware;
@@ -0,0 +1,182 @@
+// *******************************************************************************************************
+// File:      Arduino.cpp
+// Author:    agent
+// History:   2026/10/17 agent Version 1.0
+//
+// Purpose:   Host stand-in for DxCore and the EEPROM library. All state lives in the simulator
+//
+// *******************************************************************************************************
+#include <Arduino.h>
+#include <EEPROM.h>
+#include "simulator.h"
+
+VPORT_t VPORTA(0), VPORTB(1), VPORTC(2), VPORTD(3), VPORTE(4), VPORTF(5), VPORTG(6);
+PORT_t PORTA(0), PORTB(1), PORTC(2), PORTD(3), PORTE(4), PORTF(5), PORTG(6);
+TCA_t TCA0;
+NVMCTRL_t NVMCTRL;
+uint8_t SREG;
+serialClass Serial;
+EEPROMClass EEPROM;
+
+
+// *******************************************************************************************************
+// I/O registers. IN returns the driven level for outputs, and the external level for inputs
+static uint8_t inRegister(const simClass::port_t &port) {
+  return (port.out & port.dir) | (port.external & ~port.dir);
+}
+
+
+uint8_t simReadRegister(uint8_t port, uint8_t reg) {
+  const simClass::port_t &p = simulator().ports[port];
+  switch (reg) {
+    case REG_DIR: return p.dir;
+    case REG_OUT: return p.out;
+    case REG_IN: return inRegister(p);
+    default: return 0;                 // The SET, CLR and TGL registers read as 0
+  }
+}
+
+
+void simWriteRegister(uint8_t port, uint8_t reg, uint8_t value) {
+  simClass &sim = simulator();
+  simClass::port_t &p = sim.ports[port];
+  uint8_t oldIn = inRegister(p);
+  uint8_t oldOut = p.out;
+  switch (reg) {
+    case REG_DIR:    p.dir = value; break;
+    case REG_DIRSET: p.dir |= value; break;
+    case REG_DIRCLR: p.dir &= ~value; break;
+    case REG_OUT:    p.out = value; break;
+    case REG_OUTSET: p.out |= value; break;
+    case REG_OUTCLR: p.out &= ~value; break;
+    case REG_OUTTGL: p.out ^= value; break;
+    default: break;                    // IN is read-only
+  }
+  // POORT0..2 are PORTD, PORTC and PORTB
+  if ((p.out != oldOut) && (port >= 1) && (port <= 3)) sim.pinWrites.push_back({sim.now, uint8_t(3 - port), p.out});
+  sim.pinChanged(port, oldIn);
+}
+
+
+// *******************************************************************************************************
+// Pins
+void pinMode(uint8_t pin, uint8_t mode) {
+  if (mode == OUTPUT) simWriteRegister(pin / 8, REG_DIRSET, bit(pin % 8));
+    else simWriteRegister(pin / 8, REG_DIRCLR, bit(pin % 8));
+}
+
+
+void digitalWrite(uint8_t pin, uint8_t value) {
+  simWriteRegister(pin / 8, value ? REG_OUTSET : REG_OUTCLR, bit(pin % 8));
+}
+
+
+void digitalWriteFast(uint8_t pin, uint8_t value) {
+  digitalWrite(pin, value);
+}
+
+
+uint8_t digitalRead(uint8_t pin) {
+  return bitRead(simReadRegister(pin / 8, REG_IN), pin % 8);
+}
+
+
+uint8_t digitalReadFast(uint8_t pin) {
+  return digitalRead(pin);
+}
+
+
+void attachInterrupt(uint8_t pin, void (*isr)(), uint8_t mode) {
+  simulator().ports[pin / 8].isr[pin % 8] = isr;
+}
+
+
+void detachInterrupt(uint8_t pin) {
+  simulator().ports[pin / 8].isr[pin % 8] = nullptr;
+}
+
+
+void takeOverTCA0() {}
+
+
+// *******************************************************************************************************
+// Time
+unsigned long millis() {
+  return simulator().now / 1000;
+}
+
+
+unsigned long micros() {
+  return simulator().now;
+}
+
+
+void delay(unsigned long ms) {
+  simulator().advance(ms * 1000);
+}
+
+
+void delayMicroseconds(unsigned int us) {
+  simulator().advance(us);
+}
+
+
+// *******************************************************************************************************
+// EEPROM
+simBusyFlag::operator uint8_t() const {
+  return (simulator().now < simulator().eepromBusyUntil) ? NVMCTRL_EEBUSY_bm : 0;
+}
+
+
+uint8_t EEPROMClass::read(int address) {
+  return simulator().eeprom[address];
+}
+
+
+void EEPROMClass::write(int address, uint8_t value) {
+  // As on the AVR, a write waits till the previous write is completed
+  simClass &sim = simulator();
+  if (sim.now < sim.eepromBusyUntil) sim.advance(sim.eepromBusyUntil - sim.now);
+  sim.eeprom[address] = value;
+  sim.eepromWrites[address]++;
+  sim.eepromBusyUntil = sim.now + SIM_EEPROM_BUSY;
+}
+
+
+void EEPROMClass::update(int address, uint8_t value) {
+  if (read(address) != value) write(address, value);
+}
+
+
+// *******************************************************************************************************
+// Serial monitor. A print that does not fit in the transmit buffer waits, as on the AVR
+void serialClass::begin(unsigned long baud) {}
+
+
+int serialClass::availableForWrite() {
+  simClass &sim = simulator();
+  if (sim.serialFreeAt <= sim.now) return SIM_SERIAL_BUFFER;
+  int waiting = (sim.serialFreeAt - sim.now + SIM_SERIAL_BYTE - 1) / SIM_SERIAL_BYTE;
+  return (waiting >= SIM_SERIAL_BUFFER) ? 0 : SIM_SERIAL_BUFFER - waiting;
+}
+
+
+void serialClass::print(const char *text) {
+  simClass &sim = simulator();
+  for (; *text; text++) {
+    if (availableForWrite() == 0) sim.advance(sim.serialFreeAt - sim.now - (SIM_SERIAL_BUFFER - 1) * SIM_SERIAL_BYTE);
+    if (sim.serialFreeAt < sim.now) sim.serialFreeAt = sim.now;
+    sim.serialFreeAt += SIM_SERIAL_BYTE;
+    sim.serial += *text;
+  }
+}
+
+
+void serialClass::print(const std::string &text) {print(text.c_str());}
+void serialClass::print(char c) {char text[2] = {c, 0}; print(text);}
+void serialClass::print(unsigned char value) {print(std::to_string(value));}
+void serialClass::print(int value) {print(std::to_string(value));}
+void serialClass::print(unsigned int value) {print(std::to_string(value));}
+void serialClass::print(long value) {print(std::to_string(value));}
+void serialClass::print(unsigned long value) {print(std::to_string(value));}
+void serialClass::println() {print("\r\n");}
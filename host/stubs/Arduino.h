@@ -0,0 +1,182 @@
+// *******************************************************************************************************
+// File:      Arduino.h
+// Author:    agent
+// History:   2026/10/17 agent Version 1.0
+//
+// Purpose:   Host stand-in for DxCore on the AVR64DA64, used by the simulation harness (see host/README.md)
+//
+// Only what the decoder sketch uses is provided. The I/O registers are not plain variables: VPORTx and
+// PORTx of the same port share one state, writes to OUTSET / OUTCLR change OUT, and IN returns the
+// level of the pin. Thus the sketch runs unchanged, while the simulator (simulator.h) records every
+// change of an output and drives the level of every input.
+// Time is simulated: millis() and micros() return the simulated clock, and interrupts only occur
+// between two passes of loop(). Therefore cli() and sei() need not do anything.
+//
+// *******************************************************************************************************
+#pragma once
+#include <stdint.h>
+#include <stddef.h>
+#include <string>
+
+typedef bool boolean;
+typedef uint8_t byte;
+
+#define HIGH                1
+#define LOW                 0
+#define INPUT               0
+#define OUTPUT              1
+#define INPUT_PULLUP        2
+#define CHANGE              1
+#define F_CPU               24000000UL
+
+#define bit(b)                          (1UL << (b))
+#define bitRead(value, b)               (((value) >> (b)) & 0x01)
+#define bitSet(value, b)                ((value) |= (1UL << (b)))
+#define bitClear(value, b)              ((value) &= ~(1UL << (b)))
+#define bitWrite(value, b, bitvalue)    ((bitvalue) ? bitSet(value, b) : bitClear(value, b))
+#define lowByte(w)                      ((uint8_t) ((w) & 0xff))
+#define highByte(w)                     ((uint8_t) ((w) >> 8))
+
+
+// *******************************************************************************************************
+// Pins. As in DxCore, every port has 8 pin numbers: PIN_PA0 = 0, PIN_PB0 = 8, ... PIN_PG0 = 48
+#define SIM_PORTS           7                  // PORTA .. PORTG
+#define PIN_PA0  0
+#define PIN_PA1  1
+#define PIN_PA2  2
+#define PIN_PA3  3
+#define PIN_PA4  4
+#define PIN_PA5  5
+#define PIN_PA6  6
+#define PIN_PA7  7
+#define PIN_PB0  8
+#define PIN_PC0  16
+#define PIN_PD0  24
+#define PIN_PF0  40
+#define PIN_PF2  42
+#define PIN_PF5  45
+#define PIN_PG0  48
+#define PIN_PG1  49
+#define PIN_PG2  50
+#define PIN_PG6  54
+#define PIN_PG7  55
+
+void pinMode(uint8_t pin, uint8_t mode);
+void digitalWrite(uint8_t pin, uint8_t value);
+void digitalWriteFast(uint8_t pin, uint8_t value);
+uint8_t digitalRead(uint8_t pin);
+uint8_t digitalReadFast(uint8_t pin);
+void attachInterrupt(uint8_t pin, void (*isr)(), uint8_t mode);
+void detachInterrupt(uint8_t pin);
+
+
+// *******************************************************************************************************
+// I/O registers. A register object forwards reads and writes to the simulated port
+enum simRegister_t {REG_DIR, REG_DIRSET, REG_DIRCLR, REG_OUT, REG_OUTSET, REG_OUTCLR, REG_OUTTGL, REG_IN};
+uint8_t simReadRegister(uint8_t port, uint8_t reg);
+void simWriteRegister(uint8_t port, uint8_t reg, uint8_t value);
+
+class simRegister {
+  public:
+    simRegister(uint8_t port, uint8_t reg): port(port), reg(reg) {}
+    operator uint8_t() const {return simReadRegister(port, reg);}
+    simRegister &operator=(uint8_t value) {simWriteRegister(port, reg, value); return *this;}
+    simRegister &operator=(const simRegister &other) {return *this = (uint8_t)other;}
+    simRegister &operator|=(uint8_t value) {return *this = *this | value;}
+    simRegister &operator&=(uint8_t value) {return *this = *this & value;}
+
+  private:
+    const uint8_t port;
+    const uint8_t reg;
+};
+
+struct VPORT_t {
+  explicit VPORT_t(uint8_t port): DIR(port, REG_DIR), OUT(port, REG_OUT), IN(port, REG_IN) {}
+  simRegister DIR;
+  simRegister OUT;
+  simRegister IN;
+};
+
+struct PORT_t {
+  explicit PORT_t(uint8_t port): DIR(port, REG_DIR), DIRSET(port, REG_DIRSET), DIRCLR(port, REG_DIRCLR),
+    OUT(port, REG_OUT), OUTSET(port, REG_OUTSET), OUTCLR(port, REG_OUTCLR), OUTTGL(port, REG_OUTTGL),
+    IN(port, REG_IN) {}
+  simRegister DIR;
+  simRegister DIRSET;
+  simRegister DIRCLR;
+  simRegister OUT;
+  simRegister OUTSET;
+  simRegister OUTCLR;
+  simRegister OUTTGL;
+  simRegister IN;
+};
+
+extern VPORT_t VPORTA, VPORTB, VPORTC, VPORTD, VPORTE, VPORTF, VPORTG;
+extern PORT_t PORTA, PORTB, PORTC, PORTD, PORTE, PORTF, PORTG;
+
+
+// *******************************************************************************************************
+// Timer TCA0. The simulator calls TCA0_OVF_vect every ms, as long as the timer and its interrupt are on
+struct TCA_SINGLE_t {
+  uint8_t CTRLA, CTRLB, CTRLD, INTCTRL, INTFLAGS;
+  uint16_t CNT, PER, CMP0;
+};
+struct TCA_t {TCA_SINGLE_t SINGLE;};
+extern TCA_t TCA0;
+
+#define TCA_SINGLE_ENABLE_bm           0x01
+#define TCA_SINGLE_CLKSEL_DIV64_gc     0x0A
+#define TCA_SINGLE_WGMODE_NORMAL_gc    0x00
+#define TCA_SINGLE_OVF_bm              0x01
+void takeOverTCA0();
+
+#define ISR(vector) extern "C" void vector(void)
+extern "C" void TCA0_OVF_vect(void);
+
+
+// *******************************************************************************************************
+// Interrupts only occur between passes of loop(), thus there is nothing to lock
+extern uint8_t SREG;
+inline void cli() {}
+inline void sei() {}
+inline void noInterrupts() {}
+inline void interrupts() {}
+
+
+// *******************************************************************************************************
+// EEPROM controller: the EEPROM is busy for a while after each write
+class simBusyFlag {
+  public:
+    operator uint8_t() const;
+};
+struct NVMCTRL_t {simBusyFlag STATUS;};
+extern NVMCTRL_t NVMCTRL;
+#define NVMCTRL_EEBUSY_bm              0x02
+
+
+// *******************************************************************************************************
+// Time
+unsigned long millis();
+unsigned long micros();
+void delay(unsigned long ms);
+void delayMicroseconds(unsigned int us);
+
+
+// *******************************************************************************************************
+// Serial monitor. The output is collected by the simulator. The transmit buffer empties at 115200 baud
+class serialClass {
+  public:
+    void begin(unsigned long baud);
+    int availableForWrite();
+    void print(const char *text);
+    void print(const std::string &text);
+    void print(char c);
+    void print(unsigned char value);
+    void print(int value);
+    void print(unsigned int value);
+    void print(long value);
+    void print(unsigned long value);
+    template <class T> void println(T value) {print(value); println();}
+    void println();
+};
+extern serialClass Serial;
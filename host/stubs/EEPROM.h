@@ -0,0 +1,20 @@
+// *******************************************************************************************************
+// File:      EEPROM.h
+// Author:    agent
+// History:   2026/10/17 agent Version 1.0
+//
+// Purpose:   Host stand-in for the EEPROM library. The bytes live in the simulator (see simulator.h),
+//            which also counts the writes per byte, to estimate wear
+//
+// *******************************************************************************************************
+#pragma once
+#include <stdint.h>
+
+class EEPROMClass {
+  public:
+    uint8_t read(int address);
+    void write(int address, uint8_t value);
+    void update(int address, uint8_t value);     // Only writes if the value differs
+};
+
+extern EEPROMClass EEPROM;
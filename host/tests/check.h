@@ -0,0 +1,41 @@
+// *******************************************************************************************************
+// File:      check.h
+// Author:    agent
+// History:   2026/10/17 agent Version 1.0
+//
+// Purpose:   Minimal checks for the host tests. A test program runs one scenario, named on the command
+//            line, since each scenario needs its own power-up of the decoder (see simulator.h)
+//
+// *******************************************************************************************************
+#pragma once
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define CHECK(condition) do {                                                        \
+  if (!(condition)) {                                                                \
+    fprintf(stderr, "%s:%d: CHECK failed: %s\n", __FILE__, __LINE__, #condition);    \
+    exit(1);                                                                         \
+  }                                                                                  \
+} while (0)
+
+
+struct scenario_t {
+  const char *name;
+  void (*run)();
+};
+
+
+template <size_t N> int runScenario(int argc, char **argv, const scenario_t (&scenarios)[N]) {
+  for (const scenario_t &scenario : scenarios) {
+    if ((argc == 2) && !strcmp(argv[1], scenario.name)) {
+      scenario.run();
+      printf("%s: passed\n", scenario.name);
+      return 0;
+    }
+  }
+  fprintf(stderr, "usage: %s <scenario>, with scenario one of:", argv[0]);
+  for (const scenario_t &scenario : scenarios) fprintf(stderr, " %s", scenario.name);
+  fprintf(stderr, "\n");
+  return 2;
+}
@@ -0,0 +1,182 @@
+// *******************************************************************************************************
+// File:      harness_test.cpp
+// Author:    agent
+// History:   2026/10/17 agent Version 1.0
+//
+// Purpose:   Tests of the simulation harness itself: DCC in, outputs out, inputs in, RS-Bus out.
+//            The timing scenario also reports loop() passes per simulated second and the latencies
+//            from command to output and from input to feedback
+//
+// *******************************************************************************************************
+#include "simulator.h"
+#include "hardware.h"
+#include "extraCVs.h"
+#include "check.h"
+
+static simClass &sim = simulator();
+
+
+// Time (us) of the first change of an IO pin to level, after time. 0 if there is none
+static unsigned long pinChange(unsigned long after, uint8_t ioPin, uint8_t level) {
+  const ioPinMap_t &map = ioPinMap[ioPin - 1];
+  for (const simClass::pinWrite_t &write : sim.pinWrites) {
+    if ((write.time < after) || (write.poort != map.poort)) continue;
+    if (((write.out & map.bitMask) != 0) == (level == HIGH)) return write.time;
+  }
+  return 0;
+}
+
+
+// The first message handed to the RS-Bus library for address, after time. nullptr if there is none
+static const simClass::rsSent_t *sent(unsigned long after, uint8_t address) {
+  for (const simClass::rsSent_t &message : sim.rsSent) {
+    if ((message.time >= after) && (message.address == address)) return &message;
+  }
+  return nullptr;
+}
+
+
+// The first nibble on the RS-Bus for address, after time. nullptr if there is none
+static const simClass::rsBus_t *onBus(unsigned long after, uint8_t address) {
+  for (const simClass::rsBus_t &nibble : sim.rsBus) {
+    if ((nibble.time >= after) && (nibble.address == address)) return &nibble;
+  }
+  return nullptr;
+}
+
+
+// *******************************************************************************************************
+static void accessory() {
+  // Switch address 529 is IO pin 1 (CV1 = 5, CV9 = 2), which is bit 7 of POORT0
+  sim.factoryReset();
+  sim.setDip(1, SCHAKELEN);
+  sim.powerUp();
+  CHECK(sim.dir(0) == 0xFF);
+  sim.run(50000);
+  unsigned long t0 = sim.now;
+  sim.accessory(529, HIGH);
+  sim.run(10000);
+  CHECK(sim.pin(1) == HIGH);
+  CHECK(pinChange(t0, 1, HIGH) >= t0);
+  CHECK(sim.led(LED_ACC) == HIGH);
+  sim.accessory(529, LOW);
+  sim.run(10000);
+  CHECK(sim.pin(1) == LOW);
+  // Addresses of other decoders and POORTs that are MELDEN do not change anything
+  sim.accessory(528, HIGH);
+  sim.accessory(529 + 8, HIGH);
+  sim.run(10000);
+  CHECK(sim.pin(1) == LOW);
+  CHECK(sim.pin(9) == LOW);
+}
+
+
+static void freshChip() {
+  // Erased EEPROM: all CVs are 255. Dir_Override should then not make all pins outputs
+  sim.powerUp();
+  sim.run(50000);
+  for (uint8_t poort = 0; poort < 3; poort++) CHECK(sim.dir(poort) == 0x00);
+  sim.setDip(2, SCHAKELEN);
+  sim.run(300000);
+  CHECK(sim.dir(1) == 0xFF);
+}
+
+
+static void extended() {
+  // Aspect bit 0 is the first IO pin of the POORT, unless Ext_Bit_Order is set
+  sim.factoryReset();
+  sim.setCv(Ext_Address, 100);
+  sim.setDip(1, SCHAKELEN);
+  sim.setDip(2, SCHAKELEN);
+  sim.powerUp();
+  sim.run(50000);
+  sim.extended(100, 0x01);
+  sim.extended(101, 0x01);
+  sim.run(10000);
+  CHECK(sim.pin(1) == HIGH);
+  CHECK(sim.pin(8) == LOW);
+  CHECK(sim.pin(9) == HIGH);
+  sim.extended(100, 0x06);
+  sim.run(10000);
+  CHECK(sim.pin(1) == LOW);
+  CHECK(sim.pin(2) == HIGH);
+  CHECK(sim.pin(3) == HIGH);
+}
+
+
+static void feedback() {
+  // IO pin 17 is bit 7 of POORT2, which reports via RS-Bus address CV10 + 2, in bit 0 of the low nibble
+  sim.factoryReset();
+  sim.powerUp();
+  sim.run(500000);
+  for (uint8_t address = 65; address <= 67; address++) {
+    const simClass::rsSent_t *resync = sent(0, address);
+    CHECK(resync && (resync->type == 2) && (resync->value == 0));
+  }
+  unsigned long t0 = sim.now;
+  sim.setInput(17, HIGH);
+  sim.run(100000);
+  const simClass::rsSent_t *message = sent(t0, 67);
+  CHECK(message && (message->type == LowBits) && (message->value == 1));
+  // Three samples at 10 ms (CV33 = 3, CV35 = 10): at least 20 ms, at most 30 ms plus the loop
+  CHECK((message->time - t0 >= 20000) && (message->time - t0 <= 31000));
+  const simClass::rsBus_t *nibble = onBus(t0, 67);
+  CHECK(nibble && (nibble->value == 1) && (nibble->time - message->time <= sim.rsCycle));
+  CHECK(!sent(t0, 65) && !sent(t0, 66));
+}
+
+
+static void pom() {
+  // Stored CVs are answered by the library, read-only CVs by the sketch. Both via RS-Bus address 128
+  sim.factoryReset();
+  sim.powerUp();
+  sim.run(100000);
+  unsigned long t0 = sim.now;
+  sim.pomRead(Min_1Samples);
+  sim.run(50000);
+  const simClass::rsSent_t *reply = sent(t0, 128);
+  CHECK(reply && (reply->type == 2) && (reply->value == 3));
+  sim.pomWrite(Min_1Samples, 5);
+  sim.run(50000);
+  CHECK(cvValues.read(Min_1Samples) == 5);
+  t0 = sim.now;
+  sim.pomRead(Snap_Dip);
+  sim.run(50000);
+  reply = sent(t0, 128);
+  CHECK(reply && (reply->value == 0x07));
+  CHECK(cvValues.read(Snap_Dip) == 0);
+}
+
+
+static void timing() {
+  // Not a pass / fail test, but the numbers the harness was made for
+  sim.factoryReset();
+  sim.setDip(1, SCHAKELEN);
+  sim.powerUp();
+  sim.run(1000000);
+  unsigned long loops = sim.loops;
+  unsigned long t0 = sim.now;
+  sim.accessory(529, HIGH);
+  sim.setInput(17, HIGH);
+  sim.run(1000000);
+  unsigned long output = pinChange(t0, 1, HIGH);
+  const simClass::rsSent_t *message = sent(t0, 67);
+  const simClass::rsBus_t *nibble = onBus(t0, 67);
+  CHECK(output && message && nibble);
+  printf("loopCost %u us: %lu loop() passes per simulated second\n", sim.loopCost, sim.loops - loops);
+  printf("command to output: %lu us, plus the pass of loop() that handles it\n", output - t0);
+  printf("input to send4bits: %lu us, to RS-Bus: %lu us\n", message->time - t0, nibble->time - t0);
+}
+
+
+int main(int argc, char **argv) {
+  static const scenario_t scenarios[] = {
+    {"accessory", accessory},
+    {"extended", extended},
+    {"freshChip", freshChip},
+    {"feedback", feedback},
+    {"pom", pom},
+    {"timing", timing},
+  };
+  return runScenario(argc, argv, scenarios);
+}
@@ -0,0 +1,172 @@
+// *******************************************************************************************************
+// File:      input_test.cpp
+// Author:    agent
+// History:   2026/10/17 agent Version 1.0
+//
+// Purpose:   Compares the debouncing of portClass (vertical counters) with the original per-pin code,
+//            and measures the time per sample of both
+//
+// The reference below is the check() of input.cpp Version 1.0, with the pin[8] array it used. Both
+// engines get the same random waveforms, for CV33 and CV34 values including the ones that are clamped.
+// Fixed rate sampling only: with adaptive sampling CV33 and CV34 are scaled, which the original did not do.
+//
+// *******************************************************************************************************
+#include <chrono>
+#include <random>
+#include "simulator.h"
+#include "extraCVs.h"
+#include "sampler.h"
+#include "input.h"
+#include "check.h"
+
+static simClass &sim = simulator();
+
+
+// *******************************************************************************************************
+// The original engine: per pin a history of the last 8 samples and a delayBeforeOff counter
+class referencePortClass {
+  public:
+    void init() {
+      uint8_t minSamples  = cvValues.read(Min_1Samples);
+      if (minSamples == 0) {minSamples = 1;}
+      if (minSamples > 8 ) {minSamples = 8;}
+      MinSamplesMask = 1;
+      for (uint8_t i = 1; i < minSamples; i++) {MinSamplesMask = MinSamplesMask * 2 + 1;}
+      maxDelayBeforeOff = cvValues.read(Min_0Samples);
+      for (uint8_t j = 0; j < 8; j++) {
+        pin[j].pinHistory = 0;
+        pin[j].delayBeforeOff = 0;
+        pin[j].result = 0;
+      }
+    }
+
+    void check(uint8_t inRegister) {
+      for (uint8_t j = 0; j <= 7; j++) {
+        uint8_t pinValue = bitRead(inRegister, j);
+        pin[j].pinHistory = (pin[j].pinHistory << 1) + pinValue;
+        if (pinValue) pin[j].delayBeforeOff = maxDelayBeforeOff;
+          else if (pin[j].delayBeforeOff > 0) pin[j].delayBeforeOff--;
+        if (pin[j].result == 0) {
+          uint8_t relevantSamples = pin[j].pinHistory & MinSamplesMask;
+          if (relevantSamples == MinSamplesMask) pin[j].result = 1;
+        }
+        else {
+          if (pin[j].delayBeforeOff == 0) pin[j].result = 0;
+        }
+      }
+    }
+
+    uint8_t result() {
+      uint8_t value = 0;
+      for (uint8_t j = 0; j < 8; j++) value |= pin[j].result << j;
+      return value;
+    }
+
+  private:
+    struct {uint8_t pinHistory; uint8_t delayBeforeOff; uint8_t result;} pin[8];
+    uint8_t MinSamplesMask;
+    uint8_t maxDelayBeforeOff;
+};
+
+
+// *******************************************************************************************************
+// Random waveforms. Each pin toggles with its own probability, from almost never to almost always
+class waveformClass {
+  public:
+    explicit waveformClass(unsigned seed): random(seed) {
+      for (uint8_t j = 0; j < 8; j++) toggle[j] = 1.0 / (2 << j);
+    }
+
+    uint8_t next() {
+      std::uniform_real_distribution<double> uniform(0.0, 1.0);
+      for (uint8_t j = 0; j < 8; j++) {
+        if (uniform(random) < toggle[j]) level ^= bit(j);
+      }
+      return level;
+    }
+
+  private:
+    std::mt19937 random;
+    double toggle[8];
+    uint8_t level = 0;
+};
+
+
+static void configure(uint8_t min1, uint8_t min0) {
+  sim.setCv(Min_1Samples, min1);
+  sim.setCv(Min_0Samples, min0);
+  sampler.init();                     // toSamples() needs Int_Samples and Input_Mode
+}
+
+
+// *******************************************************************************************************
+static void equivalence() {
+  static const uint8_t min1Values[] = {0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 255};
+  static const uint8_t min0Values[] = {0, 1, 2, 3, 7, 8, 15, 16, 100, 150, 255};
+  sim.factoryReset();
+  unsigned seed = 1;
+  unsigned long changes = 0;
+  for (uint8_t min1 : min1Values) {
+    for (uint8_t min0 : min0Values) {
+      configure(min1, min0);
+      portClass engine;
+      referencePortClass reference;
+      engine.init(0);
+      reference.init();
+      waveformClass waveform(seed++);
+      for (unsigned long n = 0; n < 20000; n++) {
+        uint8_t sample = waveform.next();
+        uint8_t previous = engine.result;
+        engine.check(sample, 0xFF);
+        reference.check(sample);
+        if (engine.result != reference.result()) {
+          fprintf(stderr, "CV33 = %u, CV34 = %u, sample %lu: result 0x%02X, expected 0x%02X\n",
+                  min1, min0, n, engine.result, reference.result());
+          exit(1);
+        }
+        if (engine.result != previous) changes++;
+      }
+    }
+  }
+  CHECK(changes > 100000);            // The waveforms did make the results change
+}
+
+
+static void benchmark() {
+  // Host time per sample of one port. Only the ratio says something about the AVR
+  const unsigned long samples = 2000000;
+  static uint8_t waveform[4096];
+  waveformClass generator(42);
+  for (uint8_t &sample : waveform) sample = generator.next();
+  sim.factoryReset();
+  configure(3, 150);
+  portClass engine;
+  referencePortClass reference;
+  engine.init(0);
+  reference.init();
+  volatile uint8_t sink = 0;
+  auto t0 = std::chrono::steady_clock::now();
+  for (unsigned long n = 0; n < samples; n++) {
+    reference.check(waveform[n & 4095]);
+    sink = sink + reference.result();
+  }
+  auto t1 = std::chrono::steady_clock::now();
+  for (unsigned long n = 0; n < samples; n++) {
+    engine.check(waveform[n & 4095], 0xFF);
+    sink = sink + engine.result;
+  }
+  auto t2 = std::chrono::steady_clock::now();
+  double perPin = std::chrono::duration<double, std::nano>(t1 - t0).count() / samples;
+  double vertical = std::chrono::duration<double, std::nano>(t2 - t1).count() / samples;
+  printf("per pin (Version 1.0): %.1f ns per sample\n", perPin);
+  printf("vertical counters:     %.1f ns per sample (%.1fx)\n", vertical, perPin / vertical);
+}
+
+
+int main(int argc, char **argv) {
+  static const scenario_t scenarios[] = {
+    {"equivalence", equivalence},
+    {"benchmark", benchmark},
+  };
+  return runScenario(argc, argv, scenarios);
+}
@@ -0,0 +1,113 @@
+// *******************************************************************************************************
+// File:      latency_test.cpp
+// Author:    agent
+// History:   2026/10/17 agent Version 1.0
+//
+// Purpose:   Distribution of the latency from an edge on an input pin to the RS-Bus feedback, for
+//            fixed rate sampling and for event mode (CV52, Input_Mode)
+//
+// The edges come at random times, so their phase relative to the 1 ms timer and to the sampling
+// interval is uniformly distributed. The latency is measured till send4bits(); the time till the
+// nibble is on the RS-Bus depends on the RS-Bus master and is reported separately.
+//
+// *******************************************************************************************************
+#include <algorithm>
+#include <random>
+#include <vector>
+#include "simulator.h"
+#include "extraCVs.h"
+#include "check.h"
+
+static simClass &sim = simulator();
+
+#define EDGES         200             // Rising plus falling edges per mode
+#define MIN_0_SAMPLES 20              // CV34. Shorter than the default, to keep the test fast
+
+
+struct latencies_t {
+  std::vector<unsigned long> rise;    // us from the rising edge to send4bits()
+  std::vector<unsigned long> fall;    // us from the falling edge to send4bits()
+  std::vector<unsigned long> bus;     // us from send4bits() to the nibble on the RS-Bus
+};
+
+
+static unsigned long percentile(std::vector<unsigned long> values, unsigned int p) {
+  std::sort(values.begin(), values.end());
+  return values[(values.size() - 1) * p / 100];
+}
+
+
+static void print(const char *name, const std::vector<unsigned long> &values) {
+  printf("  %-12s min %6lu  p50 %6lu  p90 %6lu  p99 %6lu  max %6lu us\n", name,
+         percentile(values, 0), percentile(values, 50), percentile(values, 90),
+         percentile(values, 99), percentile(values, 100));
+}
+
+
+static latencies_t measure(uint8_t inputMode) {
+  // IO pin 17 reports via RS-Bus address 67 (see harness_test.cpp)
+  sim.factoryReset();
+  sim.setCv(Input_Mode, inputMode);
+  sim.setCv(Min_0Samples, MIN_0_SAMPLES);
+  sim.powerUp();
+  sim.run(1000000);
+  std::mt19937 random(inputMode);
+  std::uniform_int_distribution<unsigned long> pause(0, 50000);
+  latencies_t latencies;
+  uint8_t level = LOW;
+  for (unsigned int n = 0; n < EDGES; n++) {
+    // Wait a random time, then change the input in between two passes of loop()
+    unsigned long edge = sim.now + 10000 + pause(random);
+    level = !level;
+    uint8_t value = level;
+    sim.at(edge, [value]() {sim.setInput(17, value);});
+    size_t sent = sim.rsSent.size();
+    size_t bus = sim.rsBus.size();
+    while ((sim.rsSent.size() == sent) && (sim.now < edge + 10000000)) sim.run(1000);
+    CHECK(sim.rsSent.size() == sent + 1);
+    const simClass::rsSent_t &message = sim.rsSent.back();
+    CHECK((message.address == 67) && (message.value == level));
+    (level ? latencies.rise : latencies.fall).push_back(message.time - edge);
+    while ((sim.rsBus.size() == bus) && (sim.now < message.time + 1000000)) sim.run(1000);
+    CHECK(sim.rsBus.size() == bus + 1);
+    latencies.bus.push_back(sim.rsBus.back().time - message.time);
+  }
+  return latencies;
+}
+
+
+static void report(const char *mode, const latencies_t &latencies) {
+  printf("%s (CV33 = 3, CV34 = %u, CV35 = 10 ms, loopCost = %u us)\n", mode, MIN_0_SAMPLES, sim.loopCost);
+  print("rising edge", latencies.rise);
+  print("falling edge", latencies.fall);
+  print("RS-Bus", latencies.bus);
+}
+
+
+// *******************************************************************************************************
+static void fixed() {
+  latencies_t latencies = measure(0);
+  report("fixed rate", latencies);
+  // Three samples, of which the first follows the edge within one interval
+  CHECK(percentile(latencies.rise, 0) >= 20000);
+  CHECK(percentile(latencies.rise, 100) <= 30000 + 2 * sim.loopCost);
+}
+
+
+static void event() {
+  latencies_t latencies = measure(bit(INPUT_MODE_EVENT));
+  report("event mode", latencies);
+  // The first sample is taken at the edge, the next ones at the 1 ms timer ticks after one and two
+  // intervals. Thus the latency only depends on the phase of the edge relative to the 1 ms timer
+  CHECK(percentile(latencies.rise, 0) >= 19000);
+  CHECK(percentile(latencies.rise, 100) <= 20000 + 2 * sim.loopCost);
+}
+
+
+int main(int argc, char **argv) {
+  static const scenario_t scenarios[] = {
+    {"fixed", fixed},
+    {"event", event},
+  };
+  return runScenario(argc, argv, scenarios);
+}
@@ -0,0 +1,282 @@
+// *******************************************************************************************************
+// File:      noise_test.cpp
+// Author:    agent
+// History:   2026/10/17 agent Version 1.0
+//
+// Purpose:   Benchmark of the input shaping (input.h) with synthetic waveforms, to choose CV33, CV34
+//            and CV35 per type of sensor instead of by gut feeling
+//
+// Each pin of a port gets its own track: free periods with EMI spikes, alternated with occupancies
+// that start and end with contact bounce and that may have short dropouts (dirty wheels). The port is
+// sampled every Int_Samples (CV35) ms, as the sampler does in fixed rate mode, and portClass::check()
+// debounces the samples. Per setting the table shows:
+// - false/h: occupancies reported while the track was free, per hour per pin
+// - missed:  occupancies that were not reported, or that were reported free for a while (in %)
+// - the time from the start of an occupancy till it is reported (50, 90 and 99 percentile), and the
+//   time from the end of an occupancy till it is reported free (50 percentile)
+// The checks only guard the trends; the numbers are meant to be read.
+//
+// *******************************************************************************************************
+#include <algorithm>
+#include <random>
+#include "simulator.h"
+#include "extraCVs.h"
+#include "sampler.h"
+#include "input.h"
+#include "check.h"
+
+static simClass &sim = simulator();
+
+#define NOISE_DURATION     (60UL * 60 * 1000000)     // us of simulated time per setting
+#define NOISE_PINS         8
+
+
+// *******************************************************************************************************
+// The waveforms
+struct noise_t {
+  double spikeRate;                   // EMI spikes per second on a free track
+  unsigned long spikeMax;             // us: spikes last 20 us .. spikeMax
+  uint8_t bounces;                    // Contact bounces at the start and at the end: 0 .. bounces
+  unsigned long bounceMax;            // us: each bounce lasts 100 us .. bounceMax
+  double dropoutRate;                 // Dropouts per second during an occupancy
+  unsigned long dropoutLength;        // us: dropouts last 0.5 .. 1.5 times dropoutLength
+};
+
+
+class trackClass {
+  // The level of one pin over time: a list of (time, level) edges, and the occupancies
+  public:
+    trackClass(const noise_t &noise, unsigned seed);
+    uint8_t level(unsigned long time);          // Times must not decrease
+
+    struct occupancy_t {unsigned long start; unsigned long end;};
+    std::vector<occupancy_t> occupancies;
+
+  private:
+    void edge(unsigned long time, uint8_t level) {edges.push_back({time, level});}
+    unsigned long uniform(unsigned long min, unsigned long max) {
+      return std::uniform_int_distribution<unsigned long>(min, max)(random);
+    }
+    unsigned long exponential(double rate) {   // us till the next event of a Poisson process
+      return (unsigned long)(std::exponential_distribution<double>(rate)(random) * 1000000);
+    }
+    unsigned long bounce(unsigned long time, uint8_t level, uint8_t count, unsigned long max);
+    std::mt19937 random;
+    std::vector<std::pair<unsigned long, uint8_t>> edges;
+    size_t next = 0;
+    uint8_t current = 0;
+};
+
+
+trackClass::trackClass(const noise_t &noise, unsigned seed): random(seed) {
+  unsigned long time = 0;
+  while (time < NOISE_DURATION) {
+    // A free track, 2 .. 20 s, with spikes
+    unsigned long freeEnd = time + uniform(2000000, 20000000);
+    while (noise.spikeRate > 0) {
+      time += exponential(noise.spikeRate);
+      unsigned long length = uniform(20, noise.spikeMax);
+      if (time + length >= freeEnd) break;
+      edge(time, 1);
+      edge(time + length, 0);
+      time += length;
+    }
+    // An occupancy, 0.3 .. 5 s, with bounce and dropouts
+    occupancy_t occupancy = {freeEnd, freeEnd + uniform(300000, 5000000)};
+    occupancies.push_back(occupancy);
+    edge(occupancy.start, 1);
+    time = bounce(occupancy.start, 1, uniform(0, noise.bounces), noise.bounceMax);
+    while (noise.dropoutRate > 0) {
+      time += exponential(noise.dropoutRate);
+      unsigned long length = uniform(noise.dropoutLength / 2, noise.dropoutLength * 3 / 2);
+      if (time + length + 100000 >= occupancy.end) break;
+      edge(time, 0);
+      edge(time + length, 1);
+      time += length;
+    }
+    edge(occupancy.end, 0);
+    time = bounce(occupancy.end, 0, uniform(0, noise.bounces), noise.bounceMax);
+  }
+}
+
+
+unsigned long trackClass::bounce(unsigned long time, uint8_t level, uint8_t count, unsigned long max) {
+  // The contact opens and closes again count times, before it keeps its new level
+  for (uint8_t i = 0; i < count; i++) {
+    time += uniform(100, max);
+    edge(time, !level);
+    time += uniform(100, max);
+    edge(time, level);
+  }
+  return time;
+}
+
+
+uint8_t trackClass::level(unsigned long time) {
+  while ((next < edges.size()) && (edges[next].first <= time)) current = edges[next++].second;
+  return current;
+}
+
+
+// *******************************************************************************************************
+// One setting: 8 tracks on one port
+struct result_t {
+  double falsePerHour;
+  double missed;                      // %
+  double latency[3];                  // ms: 50, 90 and 99 percentile of the occupancies
+  double release;                     // ms: 50 percentile of the ends of occupancies
+};
+
+
+static double percentile(std::vector<unsigned long> &values, double p) {
+  if (values.empty()) return 0;
+  std::sort(values.begin(), values.end());
+  return values[std::min(values.size() - 1, (size_t)(p * values.size()))] / 1000.0;
+}
+
+
+static result_t measure(const noise_t &noise, uint8_t interval, uint8_t min1, uint8_t min0) {
+  sim.setCv(Int_Samples, interval);
+  sim.setCv(Min_1Samples, min1);
+  sim.setCv(Min_0Samples, min0);
+  sampler.init();                     // toSamples() needs Int_Samples and Input_Mode
+  portClass engine;
+  engine.init(0);
+  std::vector<trackClass> tracks;
+  for (uint8_t j = 0; j < NOISE_PINS; j++) tracks.emplace_back(noise, 1000 + j);
+  // Per pin: the occupancy the time is in or that comes next, and whether it was reported
+  size_t current[NOISE_PINS] = {};
+  bool reported[NOISE_PINS] = {};
+  bool missed[NOISE_PINS] = {};
+  bool releasing[NOISE_PINS] = {};    // The occupancy ended, and is not yet reported free
+  unsigned long falsePositives = 0;
+  unsigned long occupancies = 0;
+  unsigned long misses = 0;
+  std::vector<unsigned long> latencies, releases;
+  unsigned long step = interval * 1000UL;
+  for (unsigned long time = step; time < NOISE_DURATION; time += step) {
+    uint8_t sample = 0;
+    for (uint8_t j = 0; j < NOISE_PINS; j++) sample |= tracks[j].level(time) << j;
+    uint8_t previous = engine.result;
+    engine.check(sample, 0xFF);
+    for (uint8_t j = 0; j < NOISE_PINS; j++) {
+      const std::vector<trackClass::occupancy_t> &list = tracks[j].occupancies;
+      // Occupancies that ended before this sample
+      while ((current[j] < list.size()) && (list[current[j]].end < time)) {
+        occupancies++;
+        if (!reported[j] || missed[j]) misses++;
+        releasing[j] = reported[j];
+        reported[j] = missed[j] = false;
+        current[j]++;
+      }
+      if (current[j] >= list.size()) continue;
+      const trackClass::occupancy_t &occupancy = list[current[j]];
+      bool occupied = (time >= occupancy.start);
+      uint8_t rise = engine.result & ~previous & bit(j);
+      uint8_t fall = ~engine.result & previous & bit(j);
+      if (rise && !occupied) falsePositives++;
+      if (occupied && (engine.result & bit(j)) && !reported[j]) {
+        // Also if a spike just before the start made the result HIGH already
+        reported[j] = true;
+        latencies.push_back(time - occupancy.start);
+      }
+      if (fall && occupied) missed[j] = true;
+      if (fall && releasing[j]) {
+        releasing[j] = false;
+        releases.push_back(time - list[current[j] - 1].end);
+      }
+    }
+  }
+  result_t result;
+  result.falsePerHour = falsePositives * 3600e6 / NOISE_DURATION / NOISE_PINS;
+  result.missed = occupancies ? 100.0 * misses / occupancies : 0;
+  result.latency[0] = percentile(latencies, 0.50);
+  result.latency[1] = percentile(latencies, 0.90);
+  result.latency[2] = percentile(latencies, 0.99);
+  result.release = percentile(releases, 0.50);
+  return result;
+}
+
+
+static result_t row(const noise_t &noise, uint8_t interval, uint8_t min1, uint8_t min0) {
+  result_t r = measure(noise, interval, min1, min0);
+  printf("%5u %5u %5u %8.1f %7.2f %8.0f %6.0f %6.0f %8.0f\n", interval, min1, min0, r.falsePerHour,
+         r.missed, r.latency[0], r.latency[1], r.latency[2], r.release);
+  return r;
+}
+
+
+static void header(const char *title) {
+  printf("%s\n", title);
+  printf(" CV35  CV33  CV34  false/h  missed   rise50  rise90 rise99  fall50\n");
+  printf("   ms                            %%       ms      ms     ms      ms\n");
+}
+
+
+// *******************************************************************************************************
+static void bounce() {
+  // Reed contacts: up to 6 bounces of up to 3 ms at both ends, no other noise.
+  // Bounce only adds latency; no setting should give false or missed occupancies
+  static const noise_t noise = {0, 0, 6, 3000, 0, 0};
+  sim.factoryReset();
+  header("Reed contacts with bounce");
+  for (uint8_t interval : {2, 5, 10}) {
+    for (uint8_t min1 : {1, 2, 3, 5, 8}) {
+      result_t r = row(noise, interval, min1, 150 / interval);
+      CHECK((r.falsePerHour == 0) && (r.missed == 0));
+    }
+  }
+}
+
+
+static void spikes() {
+  // EMI: on average one spike per second, of 20 us .. 2 ms. More rise samples filter more spikes
+  static const noise_t noise = {1.0, 2000, 2, 1000, 0, 0};
+  sim.factoryReset();
+  header("EMI spikes on a free track");
+  for (uint8_t interval : {2, 5, 10}) {
+    double first = 0;
+    double last = 0;
+    for (uint8_t min1 : {1, 2, 3, 5, 8}) {
+      result_t r = row(noise, interval, min1, 150 / interval);
+      if (min1 == 1) first = r.falsePerHour;
+      last = r.falsePerHour;
+    }
+    CHECK(first > 0);
+    CHECK(last < first);
+  }
+}
+
+
+static void dropout() {
+  // Dirty wheels: on average two dropouts per second during an occupancy, of 20, 50 or 100 ms.
+  // The fall window (CV34 samples of CV35 ms) must be longer than the dropouts
+  sim.factoryReset();
+  for (unsigned long length : {20000UL, 50000UL, 100000UL}) {
+    noise_t noise = {0, 0, 2, 1000, 2.0, length};
+    char title[64];
+    snprintf(title, sizeof(title), "Dropouts of %lu ms (0.5 .. 1.5 times)", length / 1000);
+    header(title);
+    for (uint8_t interval : {2, 5, 10}) {
+      double first = 0;
+      double last = 0;
+      for (unsigned long window : {10, 25, 50, 150, 300}) {
+        result_t r = row(noise, interval, 3, window / interval);
+        if (window == 10) first = r.missed;
+        last = r.missed;
+      }
+      CHECK(last <= first);
+      CHECK(last < 1);
+    }
+  }
+}
+
+
+int main(int argc, char **argv) {
+  static const scenario_t scenarios[] = {
+    {"bounce", bounce},
+    {"spikes", spikes},
+    {"dropout", dropout},
+  };
+  return runScenario(argc, argv, scenarios);
+}
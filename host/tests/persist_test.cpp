@@ -0,0 +1,79 @@
+// *******************************************************************************************************
+// File:      persist_test.cpp
+// Author:    agent
+// History:   2026/10/17 agent Version 1.0
+//
+// Purpose:   Storing and restoring the input state in EEPROM (see persist.h)
+//
+// *******************************************************************************************************
+#include <algorithm>
+#include "simulator.h"
+#include "extraCVs.h"
+#include "persist.h"
+#include "check.h"
+
+static simClass &sim = simulator();
+
+
+static unsigned long slotWrites(uint8_t slot) {
+  return sim.eepromWrites[PERSIST_EEPROM + slot * PERSIST_SLOT_SIZE];
+}
+
+
+// *******************************************************************************************************
+static void restore() {
+  // A record in slot 5, in which IO pin 1 (bit 7 of POORT0) is HIGH. The resync after power-up
+  // reports it, although the pin itself is LOW
+  sim.factoryReset();
+  sim.eeprom[PERSIST_EEPROM + 4 * PERSIST_SLOT_SIZE] = 6;
+  sim.eeprom[PERSIST_EEPROM + 5 * PERSIST_SLOT_SIZE] = 7;
+  sim.eeprom[PERSIST_EEPROM + 5 * PERSIST_SLOT_SIZE + 1] = 0x80;
+  sim.eeprom[PERSIST_EEPROM + 5 * PERSIST_SLOT_SIZE + 2] = 0x00;
+  sim.eeprom[PERSIST_EEPROM + 5 * PERSIST_SLOT_SIZE + 3] = 0x00;
+  sim.powerUp();
+  sim.run(100000);
+  CHECK(!sim.rsSent.empty());
+  const simClass::rsSent_t &resync = sim.rsSent.front();
+  CHECK((resync.address == 65) && (resync.type == 2) && (resync.value == 0x01));
+}
+
+
+static void wear() {
+  // Inputs that change all the time. Each record goes into the next slot, thus all slots wear evenly
+  sim.factoryReset();
+  sim.setCv(Persist_Interval, 1);
+  sim.setCv(Min_0Samples, 10);
+  std::fill(std::begin(sim.eepromWrites), std::end(sim.eepromWrites), 0);   // Not the factory reset
+  sim.powerUp();
+  sim.run(1000000);
+  for (unsigned int n = 0; n < 400; n++) {
+    sim.setInput(17, n % 2);
+    sim.run(500000);
+  }
+  unsigned long records = 0;
+  unsigned long most = 0;
+  unsigned long least = ~0UL;
+  for (uint8_t slot = 0; slot < PERSIST_SLOTS; slot++) {
+    records += slotWrites(slot);
+    most = std::max(most, slotWrites(slot));
+    least = std::min(least, slotWrites(slot));
+  }
+  printf("%lu records in %u slots, %lu..%lu writes per slot\n", records, PERSIST_SLOTS, least, most);
+  CHECK((records >= 100) && (records <= 201));  // At most one record per CV48 seconds
+  CHECK(most - least <= 1);
+  // The CVs are not written
+  for (uint16_t i = 0; i < PERSIST_EEPROM; i++) CHECK(sim.eepromWrites[i] == 0);
+  // Expected lifetime with the default CV48: 100,000 writes per byte, one record per minute
+  double years = 100000.0 * PERSIST_SLOTS * 60 / (365.25 * 24 * 3600);
+  printf("worst case lifetime with CV48 = 60: %.1f years\n", years);
+  CHECK(years >= 10);
+}
+
+
+int main(int argc, char **argv) {
+  static const scenario_t scenarios[] = {
+    {"restore", restore},
+    {"wear", wear},
+  };
+  return runScenario(argc, argv, scenarios);
+}
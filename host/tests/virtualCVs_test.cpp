@@ -0,0 +1,83 @@
+// *******************************************************************************************************
+// File:      virtualCVs_test.cpp
+// Author:    agent
+// History:   2026/10/17 agent Version 1.0
+//
+// Purpose:   PoM reads of the read-only CVs (see virtualCVs.h): latching of 16-bit values, repeats
+//            and select CVs
+//
+// *******************************************************************************************************
+#include "simulator.h"
+#include "extraCVs.h"
+#include "dccIn.h"
+#include "check.h"
+
+static simClass &sim = simulator();
+
+
+// Sends a PoM read and returns the reply on RS-Bus address 128, or -1 if there is none
+static int read(uint16_t cv, unsigned long wait = 20000) {
+  size_t sent = sim.rsSent.size();
+  sim.pomRead(cv);
+  sim.run(wait);
+  for (size_t i = sent; i < sim.rsSent.size(); i++) {
+    if (sim.rsSent[i].address == 128) return sim.rsSent[i].value;
+  }
+  return -1;
+}
+
+
+static void write(uint16_t cv, uint8_t value) {
+  sim.pomWrite(cv, value);
+  sim.run(20000);
+}
+
+
+static void start() {
+  sim.factoryReset();
+  sim.powerUp();
+  sim.run(100000);
+}
+
+
+// *******************************************************************************************************
+static void latch() {
+  // A command station repeats the read of the low byte. If the counter changed in between, the
+  // repeat is ignored and should not latch the new value: the high byte belongs to the first read
+  start();
+  dcc_in.applied = 0x00FF;
+  CHECK(read(Acc_Applied) == 0xFF);
+  dcc_in.applied = 0x0100;
+  CHECK(read(Acc_Applied) == -1);               // Repeat within RS_POM_REPEAT ms
+  CHECK(read(Acc_Applied + 1) == 0x00);
+  // A later read of the low byte is no repeat, and latches the new value
+  sim.run(200000);
+  CHECK(read(Acc_Applied) == 0x00);
+  CHECK(read(Acc_Applied + 1) == 0x01);
+}
+
+
+static void select() {
+  // After a write to a select CV, the same CV returns another value and is answered immediately
+  start();
+  write(Diag_Select, 17);
+  CHECK(read(Diag_Select) == 17);
+  sim.setInput(17, HIGH);
+  sim.run(50000);
+  CHECK(read(Diag_Edges) == 1);
+  write(Diag_Select, 18);
+  CHECK(read(Diag_Edges) == 0);
+  write(Sched_Select, 0);
+  CHECK(read(Sched_Misses) >= 0);
+  write(Sched_Select, 1);
+  CHECK(read(Sched_Misses) >= 0);
+}
+
+
+int main(int argc, char **argv) {
+  static const scenario_t scenarios[] = {
+    {"latch", latch},
+    {"select", select},
+  };
+  return runScenario(argc, argv, scenarios);
+}
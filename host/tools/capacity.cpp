@@ -0,0 +1,215 @@
+// *******************************************************************************************************
+// File:      capacity.cpp
+// Author:    agent
+// History:   2026/10/17 agent Version 1.0
+//
+// Purpose:   Feedback latency of a whole layout: many decoders on one RS-Bus, at rising occupancy rates
+//
+//   capacity [-c <cv>=<value>]... [-n <decoders>] [-t <seconds>] [-r <events per second per decoder>]...
+//     -c  a CV of all decoders, e.g. -c 34=5 for a short fall window and thus more nibbles
+//     -n  decoders on the bus, with RS-Bus addresses 1, 4, 7, ... Default 42, which uses 126 addresses
+//     -t  seconds of occupancy events per run. Default 60
+//     -r  occupancy rate per decoder. Default a sweep of 0.5, 2, 8 and 32
+//
+// Each decoder is a copy of decoder_module (see module.h), thus runs the unchanged sketch with its own
+// RSBusClass and portClass state. All copies share the model of the RS-Bus master: every cycle of
+// rsCycle us it polls addresses 1..128, and each address may transmit one nibble per poll. The
+// decoders therefore only compete for time on the bus via that fixed cycle, as on a real layout.
+// Occupancies start at random IO pins (a Poisson process per decoder) and last 0.2 .. 2 s. If all pins
+// are occupied, the occupancy is skipped.
+// Per rate the table shows:
+// - the occupancies per second of the whole layout that were not skipped
+// - nibbles/s on the bus, and the load: the part of the polls of the used addresses that carried data
+// - the time from an input becoming HIGH till the master received the nibble that reports it
+//   (50, 90 and 99 percentile and maximum). This includes the debouncing (CV33 times CV35). Pins that
+//   become HIGH while the decoder still reports them occupied (CV34 times CV35) are not counted
+// - the 99 percentile of the time nibbles waited in the decoder, and the most nibbles that waited in
+//   one connection. A depth that keeps growing means the addresses cannot carry the events.
+//
+// *******************************************************************************************************
+#include <dlfcn.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <algorithm>
+#include <random>
+#include <string>
+#include "module.h"
+
+#define CAPACITY_START       2000000UL         // us: events start after the power-up of all decoders
+#define CAPACITY_SETTLE      3000000UL         // us after the last event, to transmit what is waiting
+#define CAPACITY_PINS        24
+
+static std::string temporaryDir;
+static unsigned int copies = 0;
+
+
+static decoderModuleClass *loadDecoder() {
+  // dlopen() returns the same copy for the same file, thus every decoder gets its own file
+  std::string copy = temporaryDir + "/decoder" + std::to_string(copies++) + ".so";
+  std::string command = "cp '" DECODER_MODULE "' '" + copy + "'";
+  if (system(command.c_str()) != 0) {
+    fprintf(stderr, "cannot copy %s\n", DECODER_MODULE);
+    exit(2);
+  }
+  void *handle = dlopen(copy.c_str(), RTLD_NOW | RTLD_LOCAL);
+  unlink(copy.c_str());
+  createDecoderModule_t create = handle ? (createDecoderModule_t)dlsym(handle, DECODER_MODULE_ENTRY) : nullptr;
+  if (!create) {
+    fprintf(stderr, "cannot load %s: %s\n", copy.c_str(), dlerror());
+    exit(2);
+  }
+  return create();
+}
+
+
+// *******************************************************************************************************
+struct event_t {unsigned long time; uint8_t ioPin; uint8_t level;};
+
+
+static std::vector<event_t> occupancies(double rate, unsigned long duration, unsigned seed) {
+  // Occupancies of free IO pins. An occupancy that finds all pins occupied is skipped
+  std::mt19937 random(seed);
+  std::exponential_distribution<double> next(rate);
+  std::uniform_int_distribution<unsigned long> length(200000, 2000000);
+  std::uniform_int_distribution<uint8_t> pin(1, CAPACITY_PINS);
+  unsigned long freeAt[CAPACITY_PINS + 1] = {};
+  std::vector<event_t> events;
+  unsigned long time = CAPACITY_START;
+  while (true) {
+    time += (unsigned long)(next(random) * 1000000);
+    if (time >= CAPACITY_START + duration) break;
+    for (uint8_t attempt = 0; attempt < CAPACITY_PINS; attempt++) {
+      uint8_t ioPin = pin(random);
+      if (freeAt[ioPin] > time) continue;
+      // The pin may become HIGH again after at least 10 ms LOW
+      freeAt[ioPin] = time + length(random);
+      events.push_back({time, ioPin, 1});
+      events.push_back({freeAt[ioPin], ioPin, 0});
+      freeAt[ioPin] += 10000;
+      break;
+    }
+  }
+  std::stable_sort(events.begin(), events.end(),
+                   [](const event_t &a, const event_t &b) {return a.time < b.time;});
+  return events;
+}
+
+
+#define NOT_REPORTED  (~0UL)
+#define STILL_HIGH    (~1UL)
+
+
+static unsigned long latency(const std::vector<moduleNibble_t> &nibbles, const event_t &event,
+                             uint8_t rsAddress) {
+  // IO pin 1 + 8 * p + i is reported via RS-Bus address rsAddress + p, in bit i of the byte.
+  // Returns STILL_HIGH if the last nibble before the event reported the pin occupied
+  uint8_t p = (event.ioPin - 1) / 8;
+  uint8_t i = (event.ioPin - 1) % 8;
+  bool highBits = (i >= 4);
+  uint8_t mask = 1 << (i % 4);
+  bool reported = false;
+  for (const moduleNibble_t &nibble : nibbles) {
+    if ((nibble.address != rsAddress + p) || (nibble.highBits != highBits)) continue;
+    if (nibble.time < event.time) reported = (nibble.value & mask);
+      else if (reported) return STILL_HIGH;
+      else if (nibble.value & mask) return nibble.time - event.time;
+  }
+  return reported ? STILL_HIGH : NOT_REPORTED;
+}
+
+
+static double percentile(std::vector<unsigned long> &values, double p) {
+  if (values.empty()) return 0;
+  std::sort(values.begin(), values.end());
+  return values[std::min(values.size() - 1, (size_t)(p * values.size()))] / 1000.0;
+}
+
+
+static std::vector<std::pair<unsigned int, unsigned int>> cvs;
+
+
+static bool measure(unsigned int decoders, double rate, unsigned long duration) {
+  std::vector<unsigned long> latencies, waits;
+  unsigned long nibbleCount = 0;
+  unsigned long unreported = 0;
+  unsigned long rises = 0;
+  unsigned int depth = 0;
+  unsigned long cycle = 0;
+  for (unsigned int d = 0; d < decoders; d++) {
+    uint8_t rsAddress = 1 + 3 * d;
+    decoderModuleClass *decoder = loadDecoder();
+    for (const std::pair<unsigned int, unsigned int> &cv : cvs) decoder->setCv(cv.first, cv.second);
+    decoder->powerUp(rsAddress);
+    std::vector<event_t> events = occupancies(rate, duration, 1000 * d + (unsigned)(rate * 10));
+    for (const event_t &event : events) {
+      decoder->runUntil(event.time);
+      decoder->setInput(event.ioPin, event.level);
+    }
+    decoder->runUntil(CAPACITY_START + duration + CAPACITY_SETTLE);
+    std::vector<moduleNibble_t> nibbles = decoder->transmitted();
+    for (const event_t &event : events) {
+      if (!event.level) continue;
+      rises++;
+      unsigned long time = latency(nibbles, event, rsAddress);
+      if (time == NOT_REPORTED) unreported++;
+        else if (time != STILL_HIGH) latencies.push_back(time);
+    }
+    for (const moduleNibble_t &nibble : nibbles) {
+      if (nibble.time < CAPACITY_START) continue;   // The resync after power-up
+      nibbleCount++;
+      waits.push_back(nibble.time - nibble.queued);
+    }
+    depth = std::max(depth, decoder->maxDepth());
+    cycle = decoder->rsCycle();
+  }
+  double seconds = (duration + CAPACITY_SETTLE) / 1e6;
+  double polls = 3.0 * decoders * seconds * 1e6 / cycle;
+  printf("%4u %8.1f %8.1f %8.0f %5.1f %7.0f %6.0f %6.0f %6.0f %7.0f %5u %5lu\n", decoders, rate,
+         rises / (duration / 1e6), nibbleCount / seconds, 100.0 * nibbleCount / polls, percentile(latencies, 0.5),
+         percentile(latencies, 0.9), percentile(latencies, 0.99), percentile(latencies, 1.0),
+         percentile(waits, 0.99), depth, unreported);
+  return !latencies.empty();
+}
+
+
+static int usage(const char *program) {
+  fprintf(stderr, "usage: %s [-c <cv>=<value>]... [-n <decoders>] [-t <seconds>] [-r <events per second "
+          "per decoder>]...\n", program);
+  return 2;
+}
+
+
+int main(int argc, char **argv) {
+  unsigned int decoders = 42;
+  unsigned long duration = 60000000;
+  std::vector<double> rates;
+  for (int i = 1; i < argc; i++) {
+    unsigned int cv, value;
+    if (!strcmp(argv[i], "-c") && (i + 1 < argc) && (sscanf(argv[i + 1], "%u=%u", &cv, &value) == 2)) {
+      cvs.push_back({cv, value});
+      i++;
+    }
+    else if ((i + 1 < argc) && !strcmp(argv[i], "-n")) decoders = atoi(argv[++i]);
+    else if ((i + 1 < argc) && !strcmp(argv[i], "-t")) duration = atol(argv[++i]) * 1000000UL;
+    else if ((i + 1 < argc) && !strcmp(argv[i], "-r")) rates.push_back(atof(argv[++i]));
+    else return usage(argv[0]);
+  }
+  if ((decoders < 1) || (decoders > 42) || !duration) return usage(argv[0]);
+  if (rates.empty()) rates = {0.5, 2, 8, 32};
+  char dir[] = "/tmp/capacityXXXXXX";
+  if (!mkdtemp(dir)) {
+    perror("mkdtemp");
+    return 2;
+  }
+  temporaryDir = dir;
+  printf("                occupancies  nibbles  load     rise to master (ms)       wait   max   not\n");
+  printf("  n    rate   layout/s       /s     %%      50     90     99    max  99 ms depth  rep.\n");
+  bool ok = true;
+  for (double rate : rates) {
+    if (!measure(decoders, rate, duration)) ok = false;
+  }
+  rmdir(dir);
+  return ok ? 0 : 1;
+}
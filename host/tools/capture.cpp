@@ -0,0 +1,57 @@
+// *******************************************************************************************************
+// File:      capture.cpp
+// Author:    agent
+// History:   2026/10/17 agent Version 1.0
+//
+// Purpose:   Prints the trace (LOG_LEVEL 3) of a scripted session on the host harness. It made the
+//            fixture tests/traces/session.trace, with which the replay tool is tested
+//
+// The session: POORT1 is SCHAKELEN (DIP switch 2) and gets accessory commands and an extended
+// accessory packet (Ext_Address = 100; replay it with -c 40=100). IO pin 1 (POORT0) and IO pin 17
+// (POORT2) are occupied and released, each time with contact bounce, partly at the same time.
+//
+// *******************************************************************************************************
+#include <stdio.h>
+#include <sstream>
+#include "simulator.h"
+#include "hardware.h"
+#include "extraCVs.h"
+
+static simClass &sim = simulator();
+
+
+static void bounce(unsigned long time, uint8_t ioPin, uint8_t level) {
+  // Two short contacts before the pin keeps its new level. With the default CV35 (10 ms) the
+  // sampler sees them, and they are shorter than the default CV33 (3 samples)
+  static const unsigned long offsets[] = {0, 12000, 25000, 34000, 52000};
+  for (uint8_t i = 0; i < 5; i++) {
+    uint8_t bounced = (i % 2) ? !level : level;
+    sim.at(time + offsets[i], [ioPin, bounced]() {sim.setInput(ioPin, bounced);});
+  }
+}
+
+
+int main() {
+  sim.factoryReset();
+  sim.setCv(Ext_Address, 100);
+  sim.setDip(2, SCHAKELEN);
+  sim.powerUp();
+  unsigned long t = sim.now + 500000;
+  bounce(t, 1, HIGH);
+  sim.at(t + 400000, []() {sim.accessory(537, HIGH);});     // IO pin 9
+  sim.at(t + 420000, []() {sim.accessory(537, HIGH);});     // A repeat
+  sim.at(t + 800000, []() {sim.accessory(542, HIGH);});     // IO pin 14
+  bounce(t + 1000000, 17, HIGH);
+  sim.at(t + 1500000, []() {sim.extended(101, 0xA5);});
+  bounce(t + 2500000, 1, LOW);
+  sim.at(t + 2600000, []() {sim.accessory(537, LOW);});
+  bounce(t + 3200000, 17, LOW);
+  sim.at(t + 3300000, []() {sim.accessory(530, HIGH);});    // IO pin 2: POORT0 is MELDEN
+  sim.run(t + 6000000 - sim.now);
+  std::istringstream lines(sim.serial);
+  std::string line;
+  while (std::getline(lines, line)) {
+    if (line.find(" T ") != std::string::npos) printf("%s\n", line.c_str());
+  }
+  return 0;
+}
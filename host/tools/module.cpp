@@ -0,0 +1,64 @@
+// *******************************************************************************************************
+// File:      module.cpp
+// Author:    agent
+// History:   2026/10/17 agent Version 1.0
+//
+// Purpose:   One decoder in a shared library (see module.h)
+//
+// *******************************************************************************************************
+#include "simulator.h"
+#include "module.h"
+
+
+class simModuleClass: public decoderModuleClass {
+  public:
+    void setCv(uint16_t cv, uint8_t value) override {
+      if (!reset) sim.factoryReset();
+      reset = true;
+      sim.setCv(cv, value);
+    }
+
+    void powerUp(uint8_t rsAddress) override {
+      if (!reset) sim.factoryReset();
+      sim.setCv(myRSAddr, rsAddress);
+      sim.powerUp();
+    }
+
+    void setInput(uint8_t ioPin, uint8_t level) override {
+      sim.setInput(ioPin, level);
+    }
+
+    void runUntil(unsigned long time) override {
+      if (time > sim.now) sim.run(time - sim.now);
+    }
+
+    std::vector<moduleNibble_t> transmitted() override {
+      std::vector<moduleNibble_t> nibbles;
+      for (const simClass::rsBus_t &nibble : sim.rsBus) {
+        nibbles.push_back({nibble.time, nibble.queued, nibble.address, nibble.type == HighBits, nibble.value});
+      }
+      return nibbles;
+    }
+
+    unsigned int maxDepth() override {
+      unsigned int depth = 0;
+      for (const RSbusConnection *connection : sim.connections) {
+        if (connection->maxDepth > depth) depth = connection->maxDepth;
+      }
+      return depth;
+    }
+
+    unsigned long rsCycle() override {
+      return sim.rsCycle;
+    }
+
+  private:
+    simClass &sim = simulator();
+    bool reset = false;               // The CVs got their defaults
+};
+
+
+extern "C" decoderModuleClass *createDecoderModule() {
+  static simModuleClass module;
+  return &module;
+}
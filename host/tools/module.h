@@ -0,0 +1,42 @@
+// *******************************************************************************************************
+// File:      module.h
+// Author:    agent
+// History:   2026/10/17 agent Version 1.0
+//
+// Purpose:   One decoder in a shared library, such that a program can load many of them
+//
+// The sketch uses global objects, thus the host harness holds one decoder per process (see
+// simulator.h). The module decoder_module contains the sketch, the stand-ins and the simulator. Each
+// copy of that file that is loaded with dlopen(RTLD_LOCAL) has its own globals, thus is a decoder of
+// its own. The program only talks to it via the virtual functions below, which run in the copy.
+//
+// *******************************************************************************************************
+#pragma once
+#include <stdint.h>
+#include <vector>
+
+
+struct moduleNibble_t {
+  unsigned long time;                 // us at which the RS-Bus master received it
+  unsigned long queued;               // us at which the decoder called send4bits() or send8bits()
+  uint8_t address;
+  bool highBits;                      // The nibble of IO pins 5..8 of the POORT
+  uint8_t value;
+};
+
+
+class decoderModuleClass {
+  public:
+    virtual ~decoderModuleClass() {}
+    virtual void setCv(uint16_t cv, uint8_t value) = 0;          // Before powerUp()
+    virtual void powerUp(uint8_t rsAddress) = 0;                 // With CV10 (myRSAddr) = rsAddress
+    virtual void setInput(uint8_t ioPin, uint8_t level) = 0;     // IO pin 1..24
+    virtual void runUntil(unsigned long time) = 0;               // us since power-up
+    virtual std::vector<moduleNibble_t> transmitted() = 0;       // Nibbles on the RS-Bus, in order
+    virtual unsigned int maxDepth() = 0;                         // Most nibbles waiting in a connection
+    virtual unsigned long rsCycle() = 0;                         // us per poll cycle of the RS-Bus master
+};
+
+
+#define DECODER_MODULE_ENTRY "createDecoderModule"
+typedef decoderModuleClass *(*createDecoderModule_t)();
@@ -0,0 +1,160 @@
+// *******************************************************************************************************
+// File:      replay.cpp
+// Author:    agent
+// History:   2026/10/17 agent Version 1.0
+//
+// Purpose:   Replays a trace of a decoder (LOG_LEVEL 3, see Code/logger.h) on the host harness, and
+//            compares what the simulated decoder does with what the real decoder did
+//
+//   replay [-c <cv>=<value>]... [-s <ms>] [-v] <trace file>
+//     -c  a CV that was programmed on the decoder. The trace does not contain the CVs
+//     -s  ms to run after the last event, to let the inputs settle. Default 2000
+//     -v  print the trace of the simulated decoder
+//
+// The inputs of the decoder are taken from the trace: DIP switch changes, DCC packets and the samples
+// of the IN registers. Each sample is applied 0.5 ms before the time it was taken, and stays till the
+// next sample of that POORT. A sampler with the same interval thus sees the same values, only with
+// another phase. The outputs of the decoder are compared event by event: the RS-Bus feedback (RS), and
+// the accessory commands (ACC), routes (ROUTE) and extended packets (EXT) it applied.
+// Exit status 0 means the replay gave the same outputs, 1 that it differs, 2 a usage error.
+//
+// *******************************************************************************************************
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string.h>
+#include "simulator.h"
+#include "trace.h"
+
+static simClass &sim = simulator();
+
+static const char * const outputKeywords[] = {"RS", "ACC", "ROUTE", "EXT"};
+
+
+static void schedule(const traceEvent_t &event, unsigned long time) {
+  const std::vector<unsigned int> &v = event.values;
+  if ((event.keyword == "IN") && (v.size() == 2)) {
+    uint8_t poort = v[0];
+    uint8_t value = v[1];
+    sim.at(time, [poort, value]() {sim.setInputs(poort, value);});
+  }
+  if ((event.keyword == "DIP") && (v.size() == 2)) {
+    uint8_t dip = v[0];
+    uint8_t setting = v[1];
+    sim.at(time, [dip, setting]() {sim.setDip(dip, setting);});
+  }
+  if ((event.keyword == "DCC") && (v.size() >= 3)) {
+    // cmdType, the bytes of the packet, and the error detection byte that packet() adds again
+    std::vector<uint8_t> bytes(v.begin() + 1, v.end() - 1);
+    sim.at(time, [bytes]() {sim.packet(bytes);});
+  }
+}
+
+
+static bool compare(const char *keyword, const std::vector<traceEvent_t> &original,
+                    const std::vector<traceEvent_t> &replayed) {
+  std::vector<traceEvent_t> a = filterTrace(original, keyword);
+  std::vector<traceEvent_t> b = filterTrace(replayed, keyword);
+  long maxShift = 0;
+  for (size_t i = 0; (i < a.size()) && (i < b.size()); i++) {
+    if (a[i].values != b[i].values) {
+      std::ostringstream av, bv;
+      for (unsigned int value : a[i].values) av << " " << value;
+      for (unsigned int value : b[i].values) bv << " " << value;
+      printf("%-5s differs at event %zu: trace%s at %ld ms, replay%s at %ld ms\n", keyword, i + 1,
+             av.str().c_str(), a[i].time, bv.str().c_str(), b[i].time);
+      return false;
+    }
+    long shift = labs(b[i].time - a[i].time);
+    if (shift > maxShift) maxShift = shift;
+  }
+  if (a.size() != b.size()) {
+    printf("%-5s differs: %zu events in the trace, %zu in the replay\n", keyword, a.size(), b.size());
+    return false;
+  }
+  printf("%-5s %zu events match, largest time shift %ld ms\n", keyword, a.size(), maxShift);
+  return true;
+}
+
+
+static int usage(const char *program) {
+  fprintf(stderr, "usage: %s [-c <cv>=<value>]... [-s <ms>] [-v] <trace file>\n", program);
+  return 2;
+}
+
+
+int main(int argc, char **argv) {
+  // STEP 1: Options and the trace
+  const char *file = nullptr;
+  unsigned long settle = 2000;
+  bool verbose = false;
+  std::vector<std::pair<unsigned int, unsigned int>> cvs;
+  for (int i = 1; i < argc; i++) {
+    unsigned int cv, value;
+    if (!strcmp(argv[i], "-c") && (i + 1 < argc) && (sscanf(argv[i + 1], "%u=%u", &cv, &value) == 2)) {
+      cvs.push_back({cv, value});
+      i++;
+    }
+    else if (!strcmp(argv[i], "-s") && (i + 1 < argc)) settle = strtoul(argv[++i], nullptr, 10);
+    else if (!strcmp(argv[i], "-v")) verbose = true;
+    else if ((argv[i][0] != '-') && !file) file = argv[i];
+    else return usage(argv[0]);
+  }
+  if (!file) return usage(argv[0]);
+  std::ifstream input(file);
+  if (!input) {
+    fprintf(stderr, "%s: cannot read %s\n", argv[0], file);
+    return 2;
+  }
+  std::vector<traceEvent_t> original = readTrace(input);
+  if (original.empty()) {
+    fprintf(stderr, "%s: no trace lines in %s\n", argv[0], file);
+    return 2;
+  }
+  unsigned int gaps = traceGaps(original);
+  if (gaps) printf("warning: %u events are missing in the trace (log overflows)\n", gaps);
+  // STEP 2: The DIP switch settings that are reported at power-up are set before power-up
+  sim.factoryReset();
+  for (const std::pair<unsigned int, unsigned int> &cv : cvs) sim.setCv(cv.first, cv.second);
+  size_t first = 0;
+  while ((first < original.size()) && (original[first].keyword == "DIP")) {
+    sim.setDip(original[first].values[0], original[first].values[1]);
+    first++;
+  }
+  sim.powerUp();
+  // STEP 3: The other inputs at the same time after the first event as in the trace. The first event
+  // is a DIP switch that setup() reported, or else the first event we inject. The timer interrupt
+  // samples at whole ms; each input is applied half a ms before
+  unsigned long base = (sim.now / 1000 + 1) * 1000;
+  for (uint8_t ms = 0; first && (ms < 100); ms++) {
+    sim.run(1000);                      // loop() prints the DIP switches of setup()
+    std::istringstream serial(sim.serial);
+    std::vector<traceEvent_t> setup = readTrace(serial);
+    if (!setup.empty()) {
+      base = ((sim.now / 1000 & ~0xFFFFUL) + setup[0].stamp) * 1000;
+      break;
+    }
+  }
+  long last = 0;
+  for (size_t i = first; i < original.size(); i++) {
+    long time = original[i].time - original[0].time;
+    schedule(original[i], base + time * 1000 - 500);
+    if (time > last) last = time;
+  }
+  sim.run(base + (last + settle) * 1000 - sim.now);
+  // STEP 4: Compare the outputs
+  std::istringstream serial(sim.serial);
+  std::vector<traceEvent_t> replayed = readTrace(serial);
+  if (verbose) {
+    std::istringstream lines(sim.serial);
+    std::string line;
+    while (std::getline(lines, line)) {
+      if (line.find(" T ") != std::string::npos) printf("%s\n", line.c_str());
+    }
+  }
+  bool same = true;
+  for (const char *keyword : outputKeywords) {
+    if (!compare(keyword, original, replayed)) same = false;
+  }
+  return same ? 0 : 1;
+}
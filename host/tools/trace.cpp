@@ -0,0 +1,53 @@
+// *******************************************************************************************************
+// File:      trace.cpp
+// Author:    agent
+// History:   2026/10/17 agent Version 1.0
+//
+// Purpose:   Reading the trace lines that a decoder prints at LOG_LEVEL 3 (see Code/logger.h)
+//
+// *******************************************************************************************************
+#include <sstream>
+#include "trace.h"
+
+
+std::vector<traceEvent_t> readTrace(std::istream &input) {
+  std::vector<traceEvent_t> trace;
+  std::string line;
+  bool first = true;
+  unsigned int lastStamp = 0;
+  long time = 0;
+  while (std::getline(input, line)) {
+    std::istringstream fields(line);
+    unsigned int stamp;
+    std::string marker;
+    traceEvent_t event;
+    if (!(fields >> stamp >> marker >> event.sequence >> event.keyword) || (marker != "T")) continue;
+    unsigned int value;
+    while (fields >> value) event.values.push_back(value);
+    if (!first) time += (int16_t)(uint16_t)(stamp - lastStamp);
+    first = false;
+    lastStamp = stamp;
+    event.time = time;
+    event.stamp = stamp;
+    trace.push_back(event);
+  }
+  return trace;
+}
+
+
+std::vector<traceEvent_t> filterTrace(const std::vector<traceEvent_t> &trace, const std::string &keyword) {
+  std::vector<traceEvent_t> result;
+  for (const traceEvent_t &event : trace) {
+    if (event.keyword == keyword) result.push_back(event);
+  }
+  return result;
+}
+
+
+unsigned int traceGaps(const std::vector<traceEvent_t> &trace) {
+  unsigned int gaps = 0;
+  for (size_t i = 1; i < trace.size(); i++) {
+    gaps += (uint16_t)(trace[i].sequence - trace[i - 1].sequence - 1);
+  }
+  return gaps;
+}
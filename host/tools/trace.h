@@ -0,0 +1,33 @@
+// *******************************************************************************************************
+// File:      trace.h
+// Author:    agent
+// History:   2026/10/17 agent Version 1.0
+//
+// Purpose:   Reading the trace lines that a decoder prints at LOG_LEVEL 3 (see Code/logger.h)
+//
+// A trace line is: <time> T <sequence> <keyword> <value> <value> ...
+// Other lines on the serial monitor are skipped. The time is in ms, lower 16 bits, and the lines
+// are printed in the order of their sequence number. Events are stamped when they were captured,
+// thus a sample may be stamped a little earlier than the event before it. readTrace() therefore
+// takes the difference with the previous line as a signed 16-bit value, to get absolute times.
+//
+// *******************************************************************************************************
+#pragma once
+#include <stdint.h>
+#include <istream>
+#include <string>
+#include <vector>
+
+
+struct traceEvent_t {
+  long time;                          // ms since the first event of the trace
+  uint16_t stamp;                     // The time as printed: millis(), lower 16 bits
+  uint16_t sequence;
+  std::string keyword;                // DIP, ACC, ROUTE, EXT, DCC, IN or RS
+  std::vector<unsigned int> values;
+};
+
+
+std::vector<traceEvent_t> readTrace(std::istream &input);
+std::vector<traceEvent_t> filterTrace(const std::vector<traceEvent_t> &trace, const std::string &keyword);
+unsigned int traceGaps(const std::vector<traceEvent_t> &trace);    // Number of missing sequence numbers